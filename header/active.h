@@ -4,6 +4,7 @@
 // Copyright Nick Brett 2007
 
 #include <vector>
+#include <pthread.h>
 #include <boost/shared_ptr.hpp>
 
 #include "vec2d.h"
@@ -30,13 +31,36 @@ class active : public item
   active( const active& );
   virtual ~active();
 
-  /** Act on the data provided by user input, AI etc */
-  virtual void update()=0;
-  virtual const float radiusSqrd() const=0;
+  const active& operator=( const active& );
+
+  /** Act on the data provided by user input, AI etc, for the tick
+      given */
+  virtual void update( const physics::tick& )=0;
+
+  /** squared radius of the bounding circle, set by the subclass */
+  const float radiusSqrd() const
+    {
+      return this->storedRadiusSqrd();
+    }
 
   // only some object types can be remote, and they'll re-implement
   // this method
   virtual kind_t kind() const { return kLOCAL; }
+
+  /** handle used by the broad phase to find its record of this
+      object, only meaningful while it is in the elementManager */
+  const size_t proxy() const
+    {
+      return m_proxy;
+    }
+
+  size_t& proxy()
+    {
+      return m_proxy;
+    }
+
+ private:
+  size_t m_proxy;
 };
 
 class shape : public active
@@ -44,25 +68,42 @@ class shape : public active
  public:
   shape( const vec2d&,const physics::clip& );
   shape( const vec2d&,const vec2d&,const physics::clip& );
+
+  /** as above, sharing the clip given with any other shapes made
+      from it rather than taking a copy */
+  shape( const vec2d&,const vec2d&,const physics::clip::ptr& );
   shape( const shape& );
   virtual ~shape();
 
   const shape& operator=( const shape& );
 
   /** Act on the data provided by user input, AI etc */
-  virtual void update()=0;
-  virtual const float radiusSqrd() const;
-
-  physics::clip& box()
-  {
-    return m_clip;
-  }
+  virtual void update( const physics::tick& )=0;
 
   const physics::clip& box() const
   {
-    return m_clip;
+    return *m_clip;
   }
 
+  /**
+   * Placed Clip
+   *
+   * returns the clip box rotated and moved to where the shape is in
+   * the world. It is built the first time it is asked for on each
+   * tick of the entityStore and shared by the narrow phase and the
+   * renderer for the rest of the tick. Safe to call from several
+   * threads at once.
+   */
+  const physics::clip& placed() const;
+
+  /** the shape has been moved, turned or reshaped other than by the
+      world, so the placed clip must be rebuilt before it is next
+      used */
+  void moved()
+    {
+      __atomic_store_n( &m_placedTick,static_cast<size_t>(kStale),__ATOMIC_RELAXED );
+    }
+
   virtual void draw();
   virtual void draw( const vec2d& );
 
@@ -72,13 +113,94 @@ class shape : public active
     }
 
  private:
-  physics::clip m_clip;	
+  enum { kStale = ~0u };
+
+  /** the outline of the shape about its center, copies of a shape
+      share it */
+  physics::clip::ptr m_clip;
+
+  mutable physics::clip   m_placed;
+
+  /** the tick m_placed was built for */
+  mutable size_t          m_placedTick;
+
+  /** held while m_placed is built */
+  mutable pthread_mutex_t m_placing;
 };
 
-const physics::collision collide( active*, active* );
-void resolveCollision( active::ptr,active::ptr,const vec2d& );
+/** returns true if items with the tag given are shapes */
+const bool hasShape( const entityStore::tag_t );
+
+/** collide two actives, the second treated as if it were moved by
+    the offset given (used to collide with an image of it across the
+    edge of the world). The narrow phase for the pair is looked up by
+    the actives' tags. Neither active is changed, so pairs may be
+    collided on several threads at once; resolveCollision() may not. */
+const physics::collision collide( active*, active*, const vec2d& = vec2d() );
+
+/** two actives to collide, the second treated as if it were moved by
+    the offset */
+struct collisionPair
+{
+  active* first;
+  active* second;
+  vec2d   offset;
+
+  /** how far the second moved relative to the first over the last
+      tick, measured at the image of the second. A particle against a
+      shape is swept back along this from where it ended up. */
+  vec2d   motion;
+};
+
+/**
+ * Collide Pairs
+ *
+ * As collide() for each of the pairs given, writing the result for
+ * each pair to the matching collision. Particles near the same shape
+ * are gathered up and swept through it together by
+ * physics::sweep(), so a fast particle can not pass through a shape
+ * between one tick and the next. Their bounding circles already
+ * cover the path of the move, see item::setSweepRadius().
+ */
+void collide( const collisionPair*, const size_t, physics::collision* );
 
-const physics::collision collideWithShape( shape*,shape* );
+/**
+ * Contact
+ *
+ * A collision between two actives found by the narrow phase. Each
+ * tick collide() produces a batch of these which the game rules, and
+ * then anything else interested, read in turn. The pointers are good
+ * until the population is next updated; the ids (entityStore slots)
+ * and tags may be kept longer.
+ */
+struct contact
+{
+  active*            first;
+  active*            second;
+  size_t             firstId;
+  size_t             secondId;
+  entityStore::tag_t firstTag;
+  entityStore::tag_t secondTag;
+
+  /** inside the world */
+  vec2d              location;
+
+  /** velocity of the second relative to the first, measured at the
+      image of the second which was hit */
+  vec2d              relativeVelocity;
+
+  /** fraction of the last tick at which they first touched, contacts
+      are resolved earliest first */
+  float              time;
+};
+
+typedef std::vector<contact> contactContainer;
+
+/** apply the game rules to a contact, which is passed over if either
+    active has been destroyed by an earlier contact */
+void resolveCollision( const contact& );
+
+const physics::collision collideWithShape( shape*,shape*,const vec2d& = vec2d() );
 void resolveCollisionWithShape( shape*,shape*,const vec2d& );
 
 class particle : public active
@@ -93,9 +215,6 @@ class particle : public active
 
   const particle& operator=( const particle& );
 
-  /** Act on the data provided by user input, AI etc */
-  virtual const float radiusSqrd() const;
-
   virtual void draw();
   virtual void draw( const vec2d& );
 
@@ -108,7 +227,9 @@ class particle : public active
   float m_radius;
 };
 
-const physics::collision collideWithParticle( shape*,particle* );
+/** collide a shape and a particle, the particle treated as if it
+    were moved by the offset given */
+const physics::collision collideWithParticle( shape*,particle*,const vec2d& = vec2d() );
 void resolveCollisionWithParticle( shape*,particle*,const vec2d&);
 
 #endif // ACTIVE_CLASS
@@ -37,7 +37,7 @@ namespace ai
 
       /** Make decisions based on current situation and update m_state
 	  container */
-      virtual void update()=0;
+      virtual void update( const physics::tick& )=0;
     };
 
   class turret : public actor
@@ -50,7 +50,7 @@ namespace ai
 
       virtual const bool state( const int ) const;
       virtual void setActiveTarget( active* ); 
-      virtual void update();
+      virtual void update( const physics::tick& );
 
     private:
       /** pointer to active object that this instance of ai is
@@ -67,6 +67,29 @@ namespace ai
       float m_tolerance;
     };
 
+  /**
+   * Pilot
+   *
+   * Flies the player's ship by pressing its keys, for runs with no
+   * one at the keyboard. Turns toward the nearest rock or turret,
+   * fires once pointing at it and thrusts while it is far away.
+   */
+  class pilot : public inputSource
+    {
+    public:
+      pilot();
+      virtual ~pilot();
+
+      virtual void poll( const physics::tick& );
+
+      /** a pilot flies for as long as it is asked to */
+      virtual const bool finished() const;
+
+    private:
+      /** thrust toward targets further away than this */
+      float m_range;
+    };
+
   /***
    * Ai Manager
    *
@@ -79,8 +102,9 @@ namespace ai
 
       static manager* create();
 
-      /** Ask all objects to update their current state */
-      void update();  
+      /** Ask all objects to update their current state for the tick
+	  given */
+      void update( const physics::tick& );
 
       /** 
 	  generate a new instance of an ai object, add it to the
@@ -0,0 +1,502 @@
+#ifndef BROADPHASE_NAMESPACE
+#define BROADPHASE_NAMESPACE
+
+// Copyright Nick Brett 2007
+// contact nickdbrett@googlemail.com
+
+#include <vector>
+#include <string>
+#include <utility>
+#include <ostream>
+
+#include "common.h"
+#include "active.h"
+
+class levelBoundary;
+
+/**
+ * broadphase namespace
+ *
+ * Strategies for finding the pairs of active objects which are close
+ * enough to collide. The elementManager hands its active population
+ * to a strategy once per tick and passes the resulting candidate
+ * pairs on to the narrow phase (::collide). Every strategy returns
+ * the same set of pairs, in the same order, so they may be swapped
+ * freely to compare their cost. The one exception is pairs of
+ * particles, which never collide and which a strategy may leave out.
+ *
+ * The world wraps around at its edges (see levelBoundary), so the
+ * separation of a pair is measured to the nearest image of the
+ * second object and each pair carries the offset to that image.
+ */
+namespace broadphase
+{
+  enum mode_t { kBruteForce, kUniformGrid, kSweepAndPrune, kAabbTree, kContactCache };
+
+  typedef std::vector<active::ptr>      container;
+
+  /**
+   * Candidate pair
+   *
+   * Indices of two actives in the population, first < second, and
+   * the offset from the second to its image nearest the first.
+   */
+  struct pair
+  {
+    pair( const size_t First, const size_t Second ):
+      first(First),
+      second(Second),
+      offset()
+    {}
+
+    pair( const size_t First, const size_t Second, const vec2d& Offset ):
+      first(First),
+      second(Second),
+      offset(Offset)
+    {}
+
+    /** pairs are ordered by index alone */
+    const bool operator<( const pair& Arg ) const
+      {
+	return (first < Arg.first) || ((first == Arg.first) && (second < Arg.second));
+      }
+
+    const bool operator==( const pair& Arg ) const
+      {
+	return (first == Arg.first) && (second == Arg.second);
+      }
+
+    size_t first;
+    size_t second;
+    vec2d  offset;
+  };
+
+  typedef std::vector<pair>             pairContainer;
+
+  /**
+   * Bounding circle test
+   *
+   * returns true unless the combined squared radi are smaller than
+   * the squared separation. This is the same test applied by
+   * ::collide(active*,active*) so no pair it would accept is lost.
+   */
+  inline const bool overlap( const float RadiusSqrdA, const float RadiusSqrdB, const float SeparationSqrd )
+    {
+      return !( (RadiusSqrdA + RadiusSqrdB) < SeparationSqrd );
+    }
+
+  /**
+   * Strategy
+   *
+   * pABC for a broad phase. findPairs() fills the container with
+   * the pairs in the population whose bounding circles overlap,
+   * allowing for the world wrapping at the boundary given, sorted by
+   * first then second.
+   *
+   * Strategies which keep state from one tick to the next are told
+   * when objects join or leave the population, and how far the world
+   * has moved on. The others ignore these calls.
+   */
+  class strategy
+    {
+    public:
+      strategy();
+      virtual ~strategy();
+
+      virtual void findPairs( const container&, const levelBoundary&, pairContainer& )=0;
+
+      /** Arg has been added to the population */
+      virtual void inserted( const active::ptr& ) {}
+
+      /** Arg is about to be removed from the population */
+      virtual void erased( const active::ptr& ) {}
+
+      /** the whole population has been removed */
+      virtual void clear() {}
+
+      /** the population has been moved on to the time given, called
+	  once a tick before findPairs() */
+      virtual void advance( const physics::time_t ) {}
+    };
+
+  /**
+   * Brute Force
+   *
+   * Tests every active against every other active, O(n^2).
+   */
+  class bruteForce : public strategy
+    {
+    public:
+      bruteForce();
+      virtual ~bruteForce();
+
+      virtual void findPairs( const container&, const levelBoundary&, pairContainer& );
+    };
+
+  /**
+   * Uniform Grid
+   *
+   * Buckets the population into cells covering the world each tick
+   * and only tests pairs from the same or neighbouring cells. The cell
+   * size is chosen from the largest bounding radius present so that
+   * any overlapping pair always lies in neighbouring cells. Cells on
+   * the edge of the world neighbour those across the edge, following
+   * the same rules as the world itself.
+   */
+  class uniformGrid : public strategy
+    {
+    public:
+      uniformGrid();
+      virtual ~uniformGrid();
+
+      virtual void findPairs( const container&, const levelBoundary&, pairContainer& );
+
+    private:
+      void testCell( const size_t, const size_t, pairContainer& ) const;
+      void testWrappedCell( const size_t, const size_t, const levelBoundary&, pairContainer& );
+
+      /** index of the cell at column, row where either may lie one
+	  cell outside the grid */
+      const size_t wrappedCell( const int, const int ) const;
+
+      /** copies of position and bounding radius, one per active */
+      std::vector<float>  m_x;
+      std::vector<float>  m_y;
+      std::vector<float>  m_radiusSqrd;
+
+      /** cell index of each active */
+      std::vector<size_t> m_cell;
+
+      /** population indices sorted by cell, m_start[c] is the first
+	  entry of cell c and m_start[c+1] one past its last */
+      std::vector<size_t> m_sorted;
+      std::vector<size_t> m_start;
+
+      size_t m_columns;
+      size_t m_rows;
+
+      std::vector<vec2d>  m_offsets;
+    };
+
+  /**
+   * Sweep And Prune
+   *
+   * Keeps the population sorted by the lower x bound of each bounding
+   * circle and sweeps along the x axis, only testing pairs whose x
+   * intervals overlap. The sorted list is kept from one tick to the
+   * next; objects move only a little between ticks so an insertion
+   * sort restores the order cheaply. Objects are added to and removed
+   * from the list as they enter and leave the population. Objects
+   * near the edge of the world are swept a second time at their
+   * images across it.
+   */
+  class sweepAndPrune : public strategy
+    {
+    public:
+      sweepAndPrune();
+      virtual ~sweepAndPrune();
+
+      virtual void findPairs( const container&, const levelBoundary&, pairContainer& );
+
+      virtual void inserted( const active::ptr& );
+      virtual void erased( const active::ptr& );
+      virtual void clear();
+
+    private:
+      /** per object record, addressed by active::proxy() */
+      struct proxy
+      {
+	active* object;
+	size_t  index;
+      };
+
+      /** an object's interval on the x axis plus a copy of the data
+	  needed for the bounding circle test */
+      struct interval
+      {
+	float  min;
+	float  max;
+	float  x;
+	float  y;
+	float  radiusSqrd;
+	size_t index;
+	size_t proxy;
+
+	const bool operator<( const interval& Arg ) const
+	  {
+	    return min < Arg.min;
+	  }
+      };
+
+      const interval refresh( const size_t ) const;
+
+      /** test an image against an interval from the list */
+      void testImage( const interval&, const interval&, const levelBoundary&, pairContainer& ) const;
+
+      std::vector<proxy>    m_proxies;
+      std::vector<size_t>   m_free;
+
+      /** largest padded radius present this tick */
+      float                 m_maxRadius;
+      std::vector<vec2d>    m_offsets;
+
+      /** images of the intervals near the edge of the world, sorted
+	  by min. interval::proxy holds the position of the original
+	  in m_intervals. */
+      std::vector<interval> m_images;
+
+      /** proxies inserted since the last sweep */
+      std::vector<size_t>   m_pending;
+
+      /** sorted by interval::min */
+      std::vector<interval> m_intervals;
+    };
+
+  /** axis aligned bounding box */
+  struct bounds
+  {
+    vec2d lower;
+    vec2d upper;
+  };
+
+  /** returns the bounds of a circle */
+  inline const bounds circleBounds( const vec2d& Center, const float Radius )
+    {
+      bounds rtn;
+
+      rtn.lower = vec2d( Center.x() - Radius, Center.y() - Radius );
+      rtn.upper = vec2d( Center.x() + Radius, Center.y() + Radius );
+
+      return rtn;
+    }
+
+  /**
+   * Dynamic Tree
+   *
+   * A bounding volume hierarchy of axis aligned boxes which can be
+   * changed one leaf at a time. Leaves are stored with a margin
+   * around the bounds they were given so that small movements do not
+   * change the tree at all. The tree is kept balanced by rotations so
+   * insert, remove and move are O(log n).
+   */
+  class dynamicTree
+    {
+    public:
+      enum { kNull = -1 };
+
+      dynamicTree();
+      ~dynamicTree();
+
+      /** add a leaf holding Data, returns the id of the leaf */
+      const int insert( const bounds&, const size_t );
+
+      void remove( const int );
+
+      /** give a leaf new bounds, the tree is only changed if they
+	  have left the leaf's padded bounds. Returns true if it was. */
+      const bool move( const int, const bounds& );
+
+      const size_t data( const int Leaf ) const
+	{
+	  return m_nodes[Leaf].data;
+	}
+
+      /** append the data of every leaf overlapping the bounds to the
+	  container */
+      void query( const bounds&, std::vector<size_t>& ) const;
+
+      void clear();
+
+    private:
+      struct node
+      {
+	bounds box;
+	int    parent;
+	int    left;
+	int    right;
+	int    height;
+	size_t data;
+
+	const bool leaf() const
+	  {
+	    return left == kNull;
+	  }
+      };
+
+      const int allocate();
+      void release( const int );
+
+      void insertLeaf( const int );
+      void removeLeaf( const int );
+      const int balance( const int );
+      void refit( const int );
+
+      std::vector<node> m_nodes;
+      int               m_root;
+      int               m_free;
+
+      mutable std::vector<int> m_stack;
+    };
+
+  /**
+   * AABB Tree
+   *
+   * Keeps the shapes in a dynamicTree and queries it with the bounds
+   * of every active. Shells far outnumber the shapes, so each shell
+   * costs O(log s) rather than a pass over every shape. Pairs of
+   * particles are never reported.
+   */
+  class aabbTree : public strategy
+    {
+    public:
+      aabbTree();
+      virtual ~aabbTree();
+
+      virtual void findPairs( const container&, const levelBoundary&, pairContainer& );
+
+      virtual void inserted( const active::ptr& );
+      virtual void erased( const active::ptr& );
+      virtual void clear();
+
+    private:
+      /** per object record, addressed by active::proxy() */
+      struct proxy
+      {
+	active* object;
+	size_t  index;
+
+	/** leaf in m_tree, dynamicTree::kNull for particles */
+	int     leaf;
+
+	float   radiusSqrd;
+      };
+
+      const bounds boundsOf( const active& ) const;
+
+      std::vector<proxy>  m_proxies;
+      std::vector<size_t> m_free;
+
+      dynamicTree         m_tree;
+      std::vector<size_t> m_hits;
+
+      /** largest padded radius of any shape this tick */
+      float               m_maxRadius;
+      std::vector<vec2d>  m_offsets;
+    };
+
+  /**
+   * Contact Cache
+   *
+   * Tests pairs as bruteForce does, but remembers for each pair found
+   * apart the earliest time at which it could touch: the gap between
+   * its bounding circles over the sum of the two speeds. The pair is
+   * not looked at again until then, so a sparse field costs little
+   * more than its close pairs. Pending tests are held in a ring of
+   * time slots.
+   *
+   * An object whose velocity is changed through item::accelerate()
+   * (see item::impulses()), or which has just joined, is tested
+   * against the whole population on the next tick and its old
+   * predictions are dropped. Tests are made a tick early to allow for
+   * swept particles, whose bounds grow with the length of the tick.
+   * Pairs of particles are never reported.
+   */
+  class contactCache : public strategy
+    {
+    public:
+      /** slots in the ring and the time covered by each, pairs which
+	  could not touch for longer are tested at the far end */
+      enum { kSlots = 256, kSlotsPerSecond = 60 };
+
+      contactCache();
+      virtual ~contactCache();
+
+      virtual void findPairs( const container&, const levelBoundary&, pairContainer& );
+
+      virtual void inserted( const active::ptr& );
+      virtual void erased( const active::ptr& );
+      virtual void clear();
+      virtual void advance( const physics::time_t );
+
+    private:
+      /** per object record, addressed by active::proxy() */
+      struct proxy
+      {
+	active*      object;
+	size_t       index;
+
+	/** copies taken at the start of the tick */
+	float        radiusSqrd;
+	float        radius;
+	float        speed;
+	bool         shape;
+
+	/** the object's item::impulses() when it was last tested
+	    against everything */
+	unsigned int impulses;
+
+	/** changed whenever the predictions made for the proxy are
+	    dropped, including when it is released */
+	unsigned int stamp;
+
+	/** to be tested against the whole population this tick */
+	bool         dirty;
+      };
+
+      /** a pair awaiting its next test, which still stands while the
+	  stamps of its proxies add up to the sum recorded */
+      struct entry
+      {
+	unsigned int first;
+	unsigned int second;
+	unsigned int stamps;
+      };
+
+      /** mark a proxy to be tested against everything this tick */
+      void disturb( const size_t );
+
+      /** test a pair of proxies, record it if it overlaps and
+	  schedule its next test */
+      void test( const size_t, const size_t, const levelBoundary&, pairContainer& );
+
+      void schedule( const entry&, const physics::time_t );
+
+      std::vector<proxy>  m_proxies;
+      std::vector<size_t> m_free;
+      std::vector<size_t> m_dirty;
+
+      /** m_slots[s % kSlots] holds the pairs due during the s'th
+	  slot since time zero */
+      std::vector< std::vector<entry> > m_slots;
+
+      /** the first slot not yet emptied */
+      size_t              m_base;
+
+      /** pairs to test on the next tick, whatever its time */
+      std::vector<entry>  m_next;
+      std::vector<entry>  m_due;
+
+      physics::time_t     m_now;
+
+      /** length of the last tick, the margin left by each prediction */
+      physics::time_t     m_step;
+    };
+
+  /** generate a new strategy of the type requested */
+  strategy* generate( const mode_t );
+
+  /** convert a name given on the command line ("brute", "grid",
+      "sweep", "tree", "cache") to a mode */
+  const mode_t mode( const std::string& ) throw( exception );
+
+  /**
+   * Benchmark
+   *
+   * Times every strategy on drifting populations of rocks and shells
+   * of 1k, 10k and 50k actives and writes the mean time per tick to
+   * the stream provided. The contact cache sits out the 50k.
+   */
+  void benchmark( std::ostream& );
+}
+
+#endif // BROADPHASE_NAMESPACE
@@ -10,6 +10,8 @@
 #include <boost/shared_ptr.hpp>
 
 #include "physics.h"
+#include "broadphase.h"
+#include "randomStream.h"
 
 #include "active.h"
 #include "passive.h"
@@ -17,9 +19,84 @@
 #include "ai.h"
 #include "game.h"
 
+class rock;
+class shell;
+class ship;
+class turret;
+
+/**
+ * Pool
+ *
+ * The members of the active population of one concrete type. They
+ * are updated by a loop which calls T::update() directly, so the
+ * call needs no vtable and can be inlined. The population owns the
+ * members, a pool only refers to them.
+ */
+template< typename T > class pool
+{
+ public:
+  void insert( T* Arg )
+    {
+      m_members.push_back( Arg );
+    }
+
+  void erase( const active* Arg )
+    {
+      typename std::vector<T*>::iterator itr( std::find( m_members.begin(),m_members.end(),Arg ) );
+
+      if( itr != m_members.end() )
+	{
+	  m_members.erase( itr );
+	}
+    }
+
+  /** drop the members which have been destroyed */
+  void prune()
+    {
+      size_t kept(0);
+
+      for( size_t i(0); i<m_members.size(); ++i )
+	{
+	  if( !m_members[i]->destroyed() )
+	    {
+	      m_members[kept++] = m_members[i];
+	    }
+	}
+
+      m_members.resize( kept );
+    }
+
+  void clear()
+    {
+      m_members.clear();
+    }
+
+  /** update the members [First,Last) for the tick given */
+  void update( const physics::tick& Tick, const size_t First, const size_t Last )
+    {
+      for( size_t i(First); i<Last; ++i )
+	{
+	  m_members[i]->T::update( Tick );
+	}
+    }
+
+  const size_t size() const
+    {
+      return m_members.size();
+    }
+
+ private:
+  std::vector<T*> m_members;
+};
+
 /**
  * Describes the limits of the game world
  *
+ * The world is closed: leaving through one edge brings an object
+ * back in through the opposite edge, mirrored along that edge (so
+ * leaving on the left near the top re-enters on the right near the
+ * bottom). Every point therefore has eight images around the world,
+ * four across the edges and four across the corners.
  */
 class levelBoundary
 {
@@ -32,13 +109,46 @@ class levelBoundary
   /**
    * Remap Position 
    *
-   * If the center of the argument is outside of the game world
-   * it's position is changed such that it is inside the game
-   * world at the correct position. If the arg's center is inside
-   * the world but parts of the arg extend outside of the world
-   * the position at which to place a copy of the arg is returned.
+   * Each item in the world whose center is outside of the game
+   * world has its position changed such that it is inside the game
+   * world at the correct position. Streams through the store.
+   */
+  void remap( entityStore& ) const;
+
+  /**
+   * Edge Copies
+   *
+   * If the arg's center is inside the world but parts of the arg
+   * extend outside of the world the position at which to draw a copy
+   * of the arg is added to the container.
+   */
+  void copies( const active::ptr,std::vector< std::pair<active::ptr,vec2d> >& ) const;
+
+  /** returns the point inside the world equivalent to the arg,
+      following the same rules as remap() */
+  const vec2d wrap( const vec2d& ) const;
+
+  /**
+   * Minimum Image
+   *
+   * returns the offset which moves the second arg to whichever of
+   * its images is nearest the first arg. The offset is zero if the
+   * second arg itself is nearest.
    */
-  void remap( active::ptr,std::vector< std::pair<active::ptr,vec2d> >& ) const;
+  const vec2d image( const vec2d&, const vec2d& ) const;
+
+  /** returns the velocity of the image of an object at Position
+      moved there by Offset (as found by image()), images across an
+      edge move mirrored along that edge */
+  const vec2d imageVelocity( const vec2d&, const vec2d&, const vec2d& ) const;
+
+  /** appends to the container the offsets of each image of the
+      first arg which lies within the distance given of the world */
+  void images( const vec2d&, const float, std::vector<vec2d>& ) const;
+
+  /** returns true if the point lies within the distance given of an
+      edge, in which case it may touch objects across that edge */
+  const bool nearEdge( const vec2d&, const float ) const;
 
   const bool overlapEdge( const active::ptr, const size_t ) const;
 
@@ -47,6 +157,11 @@ class levelBoundary
       return m_edge[Arg];
     }
 
+  const vec2d& dimension() const
+    {
+      return m_dimension;
+    }
+
   /** returns true if the point specified by the arg is within this
       boundary */
   const bool contains( const vec2d& ) const;
@@ -57,6 +172,25 @@ class levelBoundary
 };
 
 
+/**
+ * Contact Listener
+ *
+ * pABC for anything which wants to follow the collisions in the world
+ * (effects, networking, statistics) without colliding anything
+ * itself. Each tick's batch of contacts is handed to every listener,
+ * in the order they were added, after the game rules have been
+ * applied. Contacts passed over by the rules are included; the
+ * destroyed() state of each active says which survived.
+ */
+class contactListener
+{
+ public:
+  contactListener();
+  virtual ~contactListener();
+
+  virtual void contacts( const contactContainer& )=0;
+};
+
 class elementManager
 {
  public:
@@ -86,33 +220,134 @@ class elementManager
       return m_activePopulation.size();
     }
 
-  /** Ask all objects to update their current state */
-  void update();
+  /** Ask all objects to update their current state, then move the
+      world on by the tick given */
+  void update( const physics::tick& );
 
   /** Draw all elements currently on screen */
   void draw() const;
 
   /** Calculate all possible collisions */
   void collide();
+
+  /** Select the broad phase used by collide() */
+  void broadPhase( const broadphase::mode_t );
+
+  /** the contacts found by the last call to collide(), until the
+      next call to update() */
+  const contactContainer& contacts() const
+    {
+      return m_events;
+    }
+
+  /** listeners are not owned by the elementManager and must be
+      removed before they are deleted */
+  void addListener( contactListener* );
+  void removeListener( contactListener* );
 	
+  /** what each stream of random numbers is drawn for, so that one
+      draws no more or less from another */
+  enum stream_t { kLayoutStream, kOutlineStream, kRockStream, kDebrisStream, kStreamCount };
+
+  /** restart every stream from the seed given, the same seed and
+      the same input give the same game */
+  void seed( const uint64_t );
+
+  const uint64_t seed() const
+    {
+      return m_seed;
+    }
+
+  /** the stream given. Drawn from by the thread running the game
+      only, a loop shared between the workers must defer() anything
+      which needs chance. */
+  randomStream& random( const stream_t Arg )
+    {
+      return m_random[Arg];
+    }
+
   int localActives(activeContainer* dest);
   int remoteActives(activeContainer* dest);
 
  private:
   elementManager();
+
+  /** pool members updated together by one thread, fixed so that the
+      order in which their side effects are applied does not depend
+      on the number of threads */
+  enum { kUpdateGrain = 1024 };
+
+  /** candidate pairs given to the narrow phase together, for the
+      same reason */
+  enum { kCollideGrain = 256 };
+
+  /** add an active which has joined the population to the pool for
+      its type, or remove one which has left */
+  void insertIntoPool( active* );
+  void eraseFromPool( active* );
+
+  /** update the members [First,Last) of the pools taken end to end,
+      shells then rocks, ships and turrets. Called from the worker
+      threads by update(). */
+  void updatePools( const physics::tick&, const size_t, const size_t );
+
+  /** run the narrow phase on the candidates [First,Last), recording
+      the collisions found in the contact list for that chunk. Called
+      from the worker threads by collide(). */
+  void narrowPhase( const size_t, const size_t );
+
   mutable pthread_mutex_t m_mutex;
 
   static elementManager* m_ptrToSelf;
 
   passiveContainer  m_passivePopulation;
+
+  /** kept in order of entityStore slot, so walking the population
+      walks through the store from front to back */
   activeContainer   m_activePopulation; 
   activeContainer   m_activeAddEntries; 
 
-  std::vector< std::pair<active::ptr,vec2d> > m_edgeOfScreen;     
+  /** the active population again, split by entityStore::tag_t.
+      Actives of any other type are updated through the vtable. */
+  pool<rock>           m_rocks;
+  pool<shell>          m_shells;
+  pool<ship>           m_ships;
+  pool<turret>         m_turrets;
+  std::vector<active*> m_otherActives;
+
+  /** copies drawn where an object crosses the edge of the world,
+      collisions across the edge are found by the broad phase. Filled
+      by draw(). */
+  mutable std::vector< std::pair<active::ptr,vec2d> > m_edgeOfScreen;     
 
   levelBoundary  m_boundary;
 
+  broadphase::strategy*      m_broadPhase;
+  broadphase::pairContainer  m_candidates;
+
+  /** the work of the narrow phase on one chunk of m_candidates */
+  struct narrowChunk
+  {
+    /** the candidates whose actives are still alive */
+    std::vector<collisionPair>      pairs;
+
+    std::vector<physics::collision> results;
+
+    /** the collisions found, in candidate order */
+    contactContainer                contacts;
+  };
+
+  std::vector<narrowChunk>      m_chunks;
+
+  /** this tick's contacts, the lists above end to end */
+  contactContainer              m_events;
+
+  std::vector<contactListener*> m_listeners;
+
   physics::time_t m_lastUpdate;
+
+  uint64_t     m_seed;
+  randomStream m_random[kStreamCount];
 };
 
 /** generate a random distribution of arg stars and insert into elementManager */
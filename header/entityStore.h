@@ -0,0 +1,163 @@
+#ifndef ENTITYSTORE_CLASS
+#define ENTITYSTORE_CLASS
+
+// Copyright Nick Brett 2007
+// contact nickdbrett@googlemail.com
+
+#include <vector>
+#include <queue>
+#include <functional>
+#include <pthread.h>
+
+#include "vec2d.h"
+#include "physics.h"
+
+/**
+ * Entity Store
+ *
+ * Holds the state of every item in structure of arrays form, one
+ * array per field, so that passes over the whole population (moving
+ * it, wrapping it at the edge of the world) stream through contiguous
+ * memory rather than chasing pointers to objects scattered about the
+ * heap. Each item is a view onto one slot of the store.
+ *
+ * Slots are grouped into fixed size blocks which are never moved or
+ * freed, so references to a slot's fields remain valid for as long as
+ * the item lives. Free slots are reused lowest first to keep the
+ * population packed into the first few blocks.
+ *
+ * There is only one store, singleton DP.
+ */
+class entityStore
+{
+ public:
+  /** the type of item held in a slot. kShape and kParticle are given
+      by those classes and replaced by their subclasses' own tags. */
+  enum tag_t { kPassive, kShape, kParticle, kRock, kShell, kShip, kTurret, kTagCount };
+
+  enum { kBlockBits = 10, kBlockSize = 1 << kBlockBits };
+
+  struct block
+  {
+    vec2d           position[kBlockSize];
+    vec2d           velocity[kBlockSize];
+    vec2d           orientation[kBlockSize];
+    float           angle[kBlockSize];
+
+    /** cosine and sine of angle, found once each time it changes
+	for everything turned through it */
+    float           angleCos[kBlockSize];
+    float           angleSin[kBlockSize];
+    float           rotation[kBlockSize];
+    float           radiusSqrd[kBlockSize];
+
+    /** position at the start of the last move */
+    vec2d           previous[kBlockSize];
+
+    /** radius of a particle whose bounding circle is grown on each
+	move to cover the path of the move as well, zero for slots
+	which are not swept */
+    float           sweepRadius[kBlockSize];
+
+    /** time at which the slot was last moved */
+    physics::time_t time[kBlockSize];
+
+    /** counts the changes made to the velocity by item::accelerate()
+	and the like, anything predicted from the slot's motion holds
+	only while this is unchanged */
+    unsigned int    impulses[kBlockSize];
+
+    unsigned char   tag[kBlockSize];
+    bool            destroyed[kBlockSize];
+
+    /** true while the item is in the elementManager's active
+	population, only these slots are moved */
+    bool            inWorld[kBlockSize];
+  };
+
+  ~entityStore();
+
+  static entityStore* create();
+
+  /** reserve a slot, its fields are left as they were */
+  const size_t allocate();
+  void release( const size_t );
+
+  /** returns the block holding a slot */
+  block& blockOf( const size_t Slot )
+    {
+      return *m_blocks[ Slot >> kBlockBits ];
+    }
+
+  /** returns the position of a slot within its block */
+  static const size_t offset( const size_t Slot )
+    {
+      return Slot & (kBlockSize - 1);
+    }
+
+  const size_t blockCount() const
+    {
+      return m_blocks.size();
+    }
+
+  block& blockAt( const size_t Arg )
+    {
+      return *m_blocks[Arg];
+    }
+
+  /** returns the number of slots of the block given which have ever
+      been allocated, the rest need not be visited */
+  const size_t used( const size_t Block ) const
+    {
+      const size_t first( Block << kBlockBits );
+
+      return (m_size - first < kBlockSize) ? m_size - first : kBlockSize;
+    }
+
+  /** held by passes over the whole store */
+  pthread_mutex_t& mutex() const
+    {
+      return m_mutex;
+    }
+
+  /** counts the ticks of the world, items placed in the world may be
+      assumed not to have moved until it changes */
+  const size_t tick() const
+    {
+      return m_tick;
+    }
+
+  /** the world has been moved on a tick */
+  void advance()
+    {
+      ++m_tick;
+    }
+
+  /** move every slot in the world along its velocity and turn it by
+      its rotation, over the length of the tick given. A slot which
+      turns has its orientation set from its new angle. */
+  void integrate( const physics::tick& );
+
+  /** as above for the blocks [First,Last) only. Takes no lock, the
+      caller holds mutex() for the whole pass so that blocks may be
+      shared between threads. */
+  void integrate( const physics::tick&, const size_t, const size_t );
+
+ private:
+  entityStore();
+
+  static entityStore* m_ptrToSelf;
+
+  std::vector<block*> m_blocks;
+
+  /** one past the highest slot ever allocated */
+  size_t              m_size;
+
+  size_t              m_tick;
+
+  std::priority_queue< size_t,std::vector<size_t>,std::greater<size_t> > m_free;
+
+  mutable pthread_mutex_t m_mutex;
+};
+
+#endif // ENTITYSTORE_CLASS
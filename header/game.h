@@ -200,6 +200,11 @@ namespace game
       virtual ~message();
 
       virtual void draw()=0;
+
+      /** called once a tick, whether or not anything is drawn. A
+	  message which has had its time destroys itself here. */
+      virtual void update()
+	{}
 	  
       virtual void destroy()
 	{
@@ -228,6 +233,11 @@ namespace game
       static gui* create();
 
       void insert( message* );
+
+      /** update every message and forget those destroyed, once a
+	  tick */
+      void update();
+
       void draw();
 
       font& normFont()
@@ -278,6 +288,7 @@ namespace game
       virtual ~levelMessage();
       
       virtual void draw();      
+      virtual void update();
 
     private:
       size_t          m_level;
@@ -295,6 +306,7 @@ namespace game
       virtual ~gameOverMessage();
       
       virtual void draw();      
+      virtual void update();
 
     private:
       userControl* m_control;
@@ -313,6 +325,7 @@ namespace game
       virtual ~pauseMessage();
       
       virtual void draw();      
+      virtual void update();
 
     private:
       std::string m_msgString;
@@ -26,6 +26,9 @@
  * objects and strings (using font objects provided as argument) as
  * well as a drawable pABC to define an interface for any object which
  * can be drawn on screen.
+ *
+ * Built with HEADLESS defined the drawing methods do nothing and no
+ * window is ever opened, so the game needs neither GL nor a display.
  */
 namespace graphics
 {
@@ -42,7 +45,9 @@ namespace graphics
 
       static display* create();
 
-      void initialise() throw( exception );
+      /** open the window, or with Window false only start SDL for
+	  the network. There is never a window in a HEADLESS build. */
+      void initialise( const bool Window = true ) throw( exception );
       void kill();
       void update();
       void resize();
@@ -58,6 +63,13 @@ namespace graphics
 	{
 	  return m_dimension * 0.5;
 	}
+
+      /** true once a window has been opened, nothing should be drawn
+	  without one */
+      const bool window() const
+	{
+	  return m_screen != NULL;
+	}
   
       void lock();
       void unlock();
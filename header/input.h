@@ -92,11 +92,12 @@ class inputState
   /** Returns true if SDL_QUIT event seen */
   bool quit();
 
+  /** Define the state (true/false) of a user input key, called by
+      readInput() or by an inputSource in its place */
+  void setKeyState( const int, const bool );
+
  private:
   inputState();
-	
-  /** Define the state (true/false) of a user input key */
-  void setKeyState( const int, const bool );
 
 
   static inputState* m_ptrToSelf;
@@ -107,4 +108,71 @@ class inputState
 
 };
 
+/**
+ * Input Source
+ *
+ * Presses keys in place of the keyboard, for runs with no window.
+ * poll() is called once a tick instead of inputState::readInput()
+ * and sets the state of keys through inputState::setKeyState(), so
+ * the controls read them as if they had been typed.
+ */
+class inputSource
+{
+ public:
+  inputSource();
+  virtual ~inputSource();
+
+  virtual void poll( const physics::tick& )=0;
+
+  /** true once the source has nothing more to say */
+  virtual const bool finished() const=0;
+};
+
+/**
+ * Input Script
+ *
+ * Presses keys as a file says. Each line holds the tick on which
+ * something happens, counted from zero, the key and whether it goes
+ * down or up. Lines must be in tick order, those starting with '#'
+ * are ignored:
+ *
+ *   # thrust for a second, then turn left and fire
+ *   0   up   down
+ *   60  up   up
+ *   60  left down
+ *   60  x    down
+ *
+ * The keys which may be named are those the game uses, see
+ * keyFromName(). The script is finished after its last line.
+ */
+class inputScript : public inputSource
+{
+ public:
+  inputScript( const std::string& ) throw( exception );
+  virtual ~inputScript();
+
+  virtual void poll( const physics::tick& );
+  virtual const bool finished() const;
+
+ private:
+  struct event
+  {
+    size_t tick;
+    int    key;
+    bool   down;
+  };
+
+  std::vector<event> m_events;
+
+  /** the first event not yet applied */
+  size_t             m_next;
+
+  /** ticks polled so far */
+  size_t             m_ticks;
+};
+
+/** returns the SDL key for a name used in an inputScript ("up",
+    "down", "left", "right", "x", "space", "pause", "q") */
+const int keyFromName( const std::string& ) throw( exception );
+
 #endif // INPUT_CLASSES
@@ -6,6 +6,7 @@
 
 #include "vec2d.h"
 #include "graphics.h"
+#include "entityStore.h"
 
 /**
  * Item
@@ -32,84 +33,159 @@ class item : public graphics::drawable
   /** Accelerates the Item by changing its velocity */
   void accelerate( const vec2d& Acceleration )
     {
-      m_velocity += Acceleration;
+      this->velocity() += Acceleration;
+      this->kick();
       
       return;
     }
 
+  /** notes that the Item's motion has been changed other than by
+      moving along its velocity, see impulses() */
+  void kick()
+    {
+      ++m_block->impulses[m_offset];
+    }
+
+  /** counts the calls to kick(), predictions made from the Item's
+      motion hold only while this is unchanged */
+  const unsigned int impulses() const
+    {
+      return m_block->impulses[m_offset];
+    }
+
   const vec2d& position() const
     {
-      return m_position;
+      return m_block->position[m_offset];
     }
 
   vec2d& position()
     {
-      return m_position;
+      return m_block->position[m_offset];
     }
 
   const vec2d& velocity() const
     {
-      return m_velocity;
+      return m_block->velocity[m_offset];
     }
   
   vec2d& velocity()
     {
-      return m_velocity;
+      return m_block->velocity[m_offset];
     }
 
   const float rotation() const 
     {
-     return m_rotation;
+     return m_block->rotation[m_offset];
     }
 
   float& rotation()
     {
-     return m_rotation;
+     return m_block->rotation[m_offset];
     }
 
   const vec2d& orientation() const
     {
-      return m_orientation;
+      return m_block->orientation[m_offset];
     }
 	
   vec2d& orientation()
     {
-      return m_orientation;
+      return m_block->orientation[m_offset];
     }
 
   const float angle() const 
     {
-     return m_angle;
+     return m_block->angle[m_offset];
     }  
 
   void setAngle(float f) {
-    m_angle = f;
+    m_block->angle[m_offset] = f;
+    m_block->angleCos[m_offset] = std::cos(f);
+    m_block->angleSin[m_offset] = std::sin(f);
   }
 
+  /** cosine of angle(), found when the angle last changed */
+  const float angleCos() const
+    {
+      return m_block->angleCos[m_offset];
+    }
+
+  /** sine of angle() */
+  const float angleSin() const
+    {
+      return m_block->angleSin[m_offset];
+    }
+
+  /** position of the Item before it was last moved */
+  const vec2d& previous() const
+    {
+      return m_block->previous[m_offset];
+    }
+
+  /** time at which the Item was last moved */
+  const physics::time_t updateTime() const
+    {
+      return m_block->time[m_offset];
+    }
+
+  const entityStore::tag_t tag() const
+    {
+      return static_cast<entityStore::tag_t>( m_block->tag[m_offset] );
+    }
+
+  /** true while the Item is part of the world, and so is moved by
+      entityStore::integrate() */
+  const bool inWorld() const
+    {
+      return m_block->inWorld[m_offset];
+    }
+
+  bool& inWorld()
+    {
+      return m_block->inWorld[m_offset];
+    }
+
+  /** the Item's slot in the entityStore */
+  const size_t slot() const
+    {
+      return m_slot;
+    }
+
   /** Marks the Object for removal */
   virtual void destroy();										
   virtual const bool destroyed() const;
-	
- private:
-
-  /** true if the object has been marked for removal */
-  bool m_destroyed;
 
-  /** Location of the Item in the world */
-  vec2d m_position;
-
-  /** Items Velocity (Relative to the prefered frame ;-) ) */
-  vec2d m_velocity;
+ protected:
+  void setTag( const entityStore::tag_t Tag )
+    {
+      m_block->tag[m_offset] = Tag;
+    }
 
-  /** Rotational velocity */
-  float m_rotation;
+  void setRadiusSqrd( const float Arg )
+    {
+      m_block->radiusSqrd[m_offset] = Arg;
+    }
 
-  /** Direction in which Item is facing (angle clockwise from vertical) */
-  vec2d m_orientation;
+  const float storedRadiusSqrd() const
+    {
+      return m_block->radiusSqrd[m_offset];
+    }
 
-  /** angle though which item has been rotated */
-  float m_angle;
+  /** the Item's bounding circle grows to cover the path of each move,
+      from a circle of the radius given */
+  void setSweepRadius( const float Arg )
+    {
+      m_block->sweepRadius[m_offset] = Arg;
+    }
+	
+ private:
+  /** set the fields of a newly allocated slot */
+  void initialise( const vec2d&,const vec2d& );
 
+  /** the data for the Item lives in this slot of the entityStore */
+  size_t               m_slot;
+  entityStore::block*  m_block;
+  size_t               m_offset;
 };
  
 #endif // ITEM_CLASS
@@ -0,0 +1,124 @@
+#ifndef PARALLEL_NAMESPACE
+#define PARALLEL_NAMESPACE
+
+// Copyright Nick Brett 2007
+// contact nickdbrett@googlemail.com
+
+#include <vector>
+#include <pthread.h>
+#include <boost/function.hpp>
+
+/**
+ * parallel namespace
+ *
+ * Runs a loop over the population across several threads. The loop
+ * is cut into chunks of a fixed size, each chunk runs on whichever
+ * thread is free. Anything a chunk wants to change outside of the
+ * objects it was given (adding objects to the world, the score, the
+ * player's lives) is recorded in a command buffer belonging to that
+ * chunk rather than done there and then. Once every chunk is done
+ * the buffers are replayed on the calling thread in chunk order, so
+ * the result is the same as running the loop on one thread however
+ * the chunks were shared out.
+ */
+namespace parallel
+{
+  typedef boost::function< void () > command;
+
+  /**
+   * Command Buffer
+   *
+   * Commands recorded by one chunk, run in the order they were
+   * recorded by replay().
+   */
+  class commandBuffer
+    {
+    public:
+      commandBuffer();
+      ~commandBuffer();
+
+      void push( const command& );
+
+      /** run every command then forget them */
+      void replay();
+
+    private:
+      std::vector<command> m_commands;
+    };
+
+  /** returns the buffer of the chunk running on the calling thread,
+      NULL outside of workers::forEach() */
+  commandBuffer* buffer();
+
+  /** record the command in the calling thread's buffer, or run it
+      now if the thread has none */
+  void defer( const command& );
+
+  /** the body of a loop, called with the first and one past the last
+      index of a chunk */
+  typedef boost::function< void ( const size_t, const size_t ) > job;
+
+  /**
+   * Workers
+   *
+   * One thread per processor, counting the thread which calls
+   * forEach() which works alongside the others. There is only one
+   * set of workers, singleton DP.
+   */
+  class workers
+    {
+    public:
+      ~workers();
+
+      static workers* create();
+
+      /** number of threads which share a loop */
+      const size_t size() const
+	{
+	  return m_threads.size() + 1;
+	}
+
+      /**
+       * For Each
+       *
+       * Calls the job on chunks of Grain indices until [0,Count) has
+       * been covered and returns once all have finished and their
+       * command buffers have been replayed. A loop of one chunk is
+       * run on the calling thread without a buffer. The job must not
+       * call forEach() itself.
+       */
+      void forEach( const size_t, const size_t, const job& );
+
+    private:
+      workers();
+
+      static void* main( void* );
+
+      /** take chunks of the current loop until there are none left */
+      void work();
+
+      static workers* m_ptrToSelf;
+
+      std::vector<pthread_t>     m_threads;
+
+      /** guards the state of the current loop below */
+      pthread_mutex_t            m_mutex;
+      pthread_cond_t             m_start;
+      pthread_cond_t             m_done;
+
+      /** incremented as each loop starts */
+      size_t                     m_generation;
+      bool                       m_quit;
+
+      job                        m_job;
+      size_t                     m_count;
+      size_t                     m_grain;
+      size_t                     m_chunks;
+      size_t                     m_next;
+      size_t                     m_finished;
+
+      std::vector<commandBuffer> m_buffers;
+    };
+}
+
+#endif // PARALLEL_NAMESPACE
@@ -8,13 +8,16 @@
 #include <algorithm>
 #include <functional>
 #include <numeric>
+#include <iterator>
 #include <iostream>
 #include <sstream>
+#include <stdint.h>
 
 #include <SDL.h>
 
 #include "common.h"
 #include "vec2d.h"
+#include "randomStream.h"
 
 /**
  * physics namespace
@@ -27,7 +30,79 @@
 namespace physics
 {
 
-  typedef float time_t;
+  /** seconds, as read from the clocks */
+  typedef double time_t;
+
+  /** the unit in which clocks count */
+  typedef int64_t nanoseconds_t;
+
+  /**
+   * Time Source
+   *
+   * Where every clock reads the time from, in nanoseconds since some
+   * fixed point. This is the system's monotonic clock unless another
+   * source has been installed, so that a benchmark, replay or soak
+   * run can move time on itself as fast as it likes and get the same
+   * result each time.
+   */
+  class timeSource
+    {
+    public:
+      virtual ~timeSource();
+
+      virtual const nanoseconds_t now() const=0;
+
+      /** the source clocks read */
+      static const timeSource* current();
+
+      /** have clocks read Arg, which the caller keeps. NULL restores
+	  the monotonic clock. Clocks which are running should be reset
+	  afterwards as the two need not agree. */
+      static void install( const timeSource* );
+
+    private:
+      static const timeSource* m_current;
+    };
+
+  /**
+   * Monotonic Source
+   *
+   * clock_gettime( CLOCK_MONOTONIC ), which is never set back. There
+   * is only one, singleton DP.
+   */
+  class monotonicSource : public timeSource
+    {
+    public:
+      static monotonicSource* create();
+
+      virtual const nanoseconds_t now() const;
+
+    private:
+      monotonicSource();
+
+      static monotonicSource* m_ptrToSelf;
+    };
+
+  /**
+   * Simulated Source
+   *
+   * Time which only passes when it is told to. Starts at zero.
+   */
+  class simulatedSource : public timeSource
+    {
+    public:
+      simulatedSource();
+      virtual ~simulatedSource();
+
+      virtual const nanoseconds_t now() const;
+
+      /** move time on by the number of nanoseconds given */
+      void advance( const nanoseconds_t );
+
+    private:
+      /** written by one thread, may be read by any */
+      nanoseconds_t m_now;
+    };
 
   /**
    * Clock class
@@ -93,12 +168,14 @@ namespace physics
        */
       void toggle();
 
+      /** Read current time (nanoseconds) */
+      const nanoseconds_t nanoseconds() const;
+
       /**
        * Read current time (milliseconds)
        *
        * This method returns the number of milliseconds on the
-       * clock. This value is returned as an unsigned integer, there
-       * are no fractions of milliseconds.
+       * clock, including fractions of a millisecond.
        *
        */
       const time_t milliseconds() const;
@@ -144,11 +221,12 @@ namespace physics
       const std::string read() const;
 
     private:
-      /** Time when clock was last started */
-      time_t m_startTime;
+      /** Time when clock was last started, read from the current
+	  timeSource */
+      nanoseconds_t m_startTime;
       
       /** Time on clock when it was last stopped*/
-      time_t m_stopTime;
+      nanoseconds_t m_stopTime;
 
       /** Set true by a call to start, false by a call to stop */
       bool m_running;
@@ -165,10 +243,10 @@ namespace physics
     public:
       static runTime* create();
 
-      /** return time in fractions of a second as a float */
-      const float now() const
+      /** return time in fractions of a second */
+      const time_t now() const
 	{
-	  return this->milliseconds() * 0.001;
+	  return this->nanoseconds() * 1e-9;
 	}
 
     private:
@@ -177,12 +255,39 @@ namespace physics
       static runTime* m_pointerToSelf;
     };
 
+  /**
+   * Tick
+   *
+   * One fixed step of the simulation. Everything updated on the step
+   * reads the time from here rather than from the clock, so the whole
+   * world moves over the same interval however long the step takes
+   * to run.
+   */
+  struct tick
+  {
+    /** steps per second of simulated time */
+    enum { kRate = 60 };
+
+    explicit tick( const time_t Now ):
+      now(Now),
+      length( 1.0 / kRate )
+    {}
+
+    /** simulated time at the end of the step */
+    time_t now;
+    time_t length;
+  };
+
 
   class collision
     {
     public:
       collision();
       collision( const vec2d& );
+      collision( const vec2d&,const vec2d&,const float );
+
+      /** a swept point hit at the fraction of its move given */
+      collision( const vec2d&,const float );
       collision( const collision& );
 
       const bool result() const
@@ -195,9 +300,33 @@ namespace physics
 	  return m_location;
 	}
 
+      /** unit vector along which the second body must move to stop
+	  overlapping the first, zero if not known */
+      const vec2d& normal() const
+	{
+	  return m_normal;
+	}
+
+      /** distance the second body must move along normal(), zero if
+	  not known */
+      const float depth() const
+	{
+	  return m_depth;
+	}
+
+      /** fraction of the last move at which the bodies first touched,
+	  one unless the collision was found by sweeping */
+      const float time() const
+	{
+	  return m_time;
+	}
+
     private:
       bool  m_result;
       vec2d m_location;
+      vec2d m_normal;
+      float m_depth;
+      float m_time;
     };
   	
   /**
@@ -255,50 +384,132 @@ namespace physics
    * Bounds the space occupied by an item in the game world. This
    * class is used to calculate collisions between object and
    * currently used to provide a graphical representation as well.
+   *
+   * The vertices are held within the clip itself, their x and y
+   * coordinates in separate arrays, so that copying a clip or
+   * resetting it never touches the heap and the collision tests can
+   * read four coordinates at a time. A clip holds at most kCapacity
+   * vertices.
+   *
+   * When it is made the outline is cut into triangles, and the
+   * triangles merged back into as few convex pieces as they can be,
+   * so that any two clips can be tested piece by piece with the
+   * separating axis test. A convex clip is a single piece.
    */  
   class clip
     {
     public:
+      /** a multiple of four, the largest clips made (rocks) have
+	  10. Their pieces have at most kCorners corners between them. */
+      enum { kCapacity = 12, kCorners = 3*(kCapacity - 2) };
+
       typedef std::vector<vec2d> container;
-      typedef container::iterator iterator;
-      typedef container::const_iterator const_iterator;
+
+      /** clips shared between shapes are never changed */
+      typedef boost::shared_ptr<const clip> ptr;
+
+      /**
+       * Const Iterator
+       *
+       * Walks the vertices in order, making each into a vec2d as it
+       * is reached. The vertices can not be changed through it.
+       */
+      class const_iterator
+	{
+	public:
+	  typedef std::forward_iterator_tag iterator_category;
+	  typedef vec2d                     value_type;
+	  typedef std::ptrdiff_t            difference_type;
+	  typedef const vec2d*              pointer;
+	  typedef const vec2d&              reference;
+
+	  const_iterator():
+	    m_clip(NULL),
+	    m_index(0),
+	    m_value()
+	    {}
+
+	  const_iterator( const clip* Clip, const size_t Index ):
+	    m_clip(Clip),
+	    m_index(Index),
+	    m_value()
+	    {}
+
+	  const vec2d& operator*() const
+	    {
+	      m_value.set( m_clip->m_x[m_index], m_clip->m_y[m_index] );
+	      return m_value;
+	    }
+
+	  const vec2d* operator->() const
+	    {
+	      return &(this->operator*());
+	    }
+
+	  const_iterator& operator++()
+	    {
+	      ++m_index;
+	      return *this;
+	    }
+
+	  const_iterator operator++( int )
+	    {
+	      const_iterator rtn( *this );
+	      ++m_index;
+	      return rtn;
+	    }
+
+	  const bool operator==( const const_iterator& Arg ) const
+	    {
+	      return m_index == Arg.m_index;
+	    }
+
+	  const bool operator!=( const const_iterator& Arg ) const
+	    {
+	      return m_index != Arg.m_index;
+	    }
+
+	private:
+	  const clip*   m_clip;
+	  size_t        m_index;
+	  mutable vec2d m_value;
+	};
+
+      typedef const_iterator iterator;
 
       clip();
       clip( const vec2d&,const vec2d& );
-      clip( const container& );
+      clip( const container& ) throw( exception );
       clip( const clip& );
       ~clip();
 
       const clip& operator=( const clip& );
 
-      iterator begin()
-	{
-	  return m_vertex.begin();
-	}
-
-      iterator end()
+      const_iterator begin() const
 	{
-	  return m_vertex.end();
+	  return const_iterator( this,0 );
 	}
 
-      const_iterator begin() const
+      const_iterator end() const
 	{
-	  return m_vertex.begin();
+	  return const_iterator( this,m_size );
 	}
 
-      const_iterator end() const
+      const vec2d at( const size_t Arg ) const
 	{
-	  return m_vertex.end();
+	  return vec2d( m_x[Arg],m_y[Arg] );
 	}
 
-      vec2d& at( const size_t Arg )
+      /** the x coordinates of the vertices, size() of them */
+      const float* x() const
 	{
-	  return m_vertex.at(Arg);
+	  return m_x;
 	}
 
-      const vec2d& at( const size_t Arg ) const
+      /** the y coordinates of the vertices */
+      const float* y() const
 	{
-	  return m_vertex.at(Arg);
+	  return m_y;
 	}
 
       vec2d& center()
@@ -319,7 +530,7 @@ namespace physics
       /** returns the number of vetexs */
       const size_t size() const
 	{
-	  return m_vertex.size();
+	  return m_size;
 	}
 
       /** returns nth side of clip box, including side between last
@@ -330,38 +541,172 @@ namespace physics
 	{
 	  return this->size();
 	}
+
+      /** returns the unit normal of the nth side, as line() */
+      const vec2d normal( const size_t Arg ) const
+	{
+	  return vec2d( m_normalX[Arg],m_normalY[Arg] );
+	}
+
+      /** the x parts of the side normals, size() of them */
+      const float* normalX() const
+	{
+	  return m_normalX;
+	}
+
+      const float* normalY() const
+	{
+	  return m_normalY;
+	}
+
+      /** returns true if no corner of the clip points inwards */
+      const bool convex() const
+	{
+	  return m_convex;
+	}
+
+      /** returns the number of convex pieces */
+      const size_t pieces() const
+	{
+	  return m_pieces;
+	}
+
+      /** the corners of the nth piece are [pieceBegin(),pieceEnd()),
+	  wound the same way as the clip */
+      const size_t pieceBegin( const size_t Arg ) const
+	{
+	  return (Arg == 0) ? 0 : m_pieceEnd[Arg - 1];
+	}
+
+      const size_t pieceEnd( const size_t Arg ) const
+	{
+	  return m_pieceEnd[Arg];
+	}
+
+      /** returns the vertex at the nth corner */
+      const size_t corner( const size_t Arg ) const
+	{
+	  return m_corner[Arg];
+	}
+
+      /** returns the unit normal, pointing out of its piece, of the
+	  side from the nth corner to the next of the same piece */
+      const vec2d cornerNormal( const size_t Arg ) const
+	{
+	  return vec2d( m_cornerNormalX[Arg],m_cornerNormalY[Arg] );
+	}
+
+      /** returns the center of the nth piece's bounding circle */
+      const vec2d pieceCenter( const size_t Arg ) const
+	{
+	  return vec2d( m_pieceX[Arg],m_pieceY[Arg] );
+	}
+
+      /** the nth piece lies within this distance of its center */
+      const float pieceRadius( const size_t Arg ) const
+	{
+	  return m_pieceRadius[Arg];
+	}
+
+      /** returns the number of triangles the clip was cut into */
+      const size_t triangles() const
+	{
+	  return m_triangles;
+	}
+
+      /** returns the three vertices of the nth triangle */
+      const unsigned char* triangle( const size_t Arg ) const
+	{
+	  return m_triangle + 3*Arg;
+	}
       
       /** revert to original vertex configuration */
       void reset();
 
+      friend void rotate( clip&,const float,const float );
+      friend void translate( clip&,const vec2d& );
+      friend void transform( const clip&,const float,const float,const vec2d&,clip& );
+
     private:
       void findCenter();
       void findRadiusSqrd();
 
-      container m_backup;
-      container m_vertex;
+      /** find the side normals from the vertices and whether the
+	  clip is convex */
+      void findNormals();
+
+      /** cut the clip into triangles then merge them into convex
+	  pieces */
+      void findPieces();
+
+      /** find the side normals and bounding circle of each piece */
+      void placePieces();
+
+      /** take the pieces and triangles of another clip */
+      void copyPieces( const clip& );
+
+      /** the vertices as made, centered */
+      float     m_backupX[kCapacity] __attribute__((aligned(16)));
+      float     m_backupY[kCapacity] __attribute__((aligned(16)));
+
+      float     m_x[kCapacity] __attribute__((aligned(16)));
+      float     m_y[kCapacity] __attribute__((aligned(16)));
+
+      /** turned with the vertices, but not moved */
+      float     m_normalX[kCapacity] __attribute__((aligned(16)));
+      float     m_normalY[kCapacity] __attribute__((aligned(16)));
+
+      size_t    m_size;
       float     m_radiusSqrd;
       vec2d     m_center;
+      bool      m_convex;
+
+      /** the corners of every piece, one piece after another */
+      unsigned char m_corner[kCorners];
+      float         m_cornerNormalX[kCorners] __attribute__((aligned(16)));
+      float         m_cornerNormalY[kCorners] __attribute__((aligned(16)));
+
+      /** one past the last corner of each piece */
+      unsigned char m_pieceEnd[kCapacity];
+      float         m_pieceX[kCapacity] __attribute__((aligned(16)));
+      float         m_pieceY[kCapacity] __attribute__((aligned(16)));
+      float         m_pieceRadius[kCapacity];
+      size_t        m_pieces;
+
+      unsigned char m_triangle[kCorners];
+      size_t        m_triangles;
     };
 
-  /** rotate all points in a clip about its center by the angle
-      provided */
+  /** rotate all points in a clip, and its side normals, about its
+      center by the angle provided */
   void rotate( clip&, const float ); 
 
+  /** as above by the angle whose cosine and sine are given */
+  void rotate( clip&, const float, const float );
+
   /** translate all points in a clip along the vector provided */
   void translate( clip&, const vec2d& );
 
   /** rotate and translate a clip using the arguments */
   void transform( clip&,const float,const vec2d& );
 
+  /** rotate and translate a copy of the first clip, which is left
+      alone, into the last */
+  void transform( const clip&,const float,const vec2d&,clip& );
+
+  /** as above, turning by the angle whose cosine and sine are
+      given */
+  void transform( const clip&,const float,const float,const vec2d&,clip& );
+
   /** generate clip box in the shape of and equalatural triangle */
   const clip triangleClip( const float );
 
   /** generate triangular clip box for player's ship */
   const clip shipClip( const float );
 
-  /** generate random circular rock shaped clip box for asteroids */
-  const clip rockClip( const float, const size_t );
+  /** generate random circular rock shaped clip box for asteroids,
+      its corners drawn from the stream given */
+  const clip rockClip( const float, const size_t, randomStream& );
 
   /** generate appropriatly shaped clip box for gun turrets */
   const clip turretClip();
@@ -371,6 +716,15 @@ namespace physics
    * 
    * returns the location of any collision beween two clip boxes and
    * a bool stateing weather or not a collision took place.
+   *
+   * Convex clips are tested by the separating axis theorem, using
+   * each clip's side normals as the axes, stopping at the first axis
+   * which separates them. The collision then also gives the normal
+   * and depth of the overlap, and its location is the deepest point
+   * of one clip inside the other. Otherwise each convex piece of one
+   * clip is tested in the same way against each piece of the other
+   * whose bounding circle it meets, and the deepest overlap found is
+   * returned.
    */
   const collision collide( const clip&, const clip& );
 
@@ -386,6 +740,30 @@ namespace physics
    */
   const collision collide( const vec2d&, const clip& );
 
+  /**
+   * Collide Many Points With A Clip Box
+   *
+   * As above for the Count points whose coordinates are given in the
+   * two arrays, setting the matching entry of the hit mask to 1 if the
+   * point is inside the clip and 0 if not. Each side of the clip is
+   * tested against four points at a time where SSE2 is available.
+   */
+  void collide( const float*, const float*, const size_t, const clip&, unsigned char* );
+
+  /**
+   * Sweep Many Points Through A Clip Box
+   *
+   * As above for Count points each moving along a straight line from
+   * its start (the first pair of arrays) to its end (the second
+   * pair), so that a fast point can not pass through a thin clip
+   * between one test and the next. A point hits if it starts inside
+   * the clip or its path crosses a side. The matching entry of Times
+   * is set to the fraction of the move at which it first touched the
+   * clip, zero if it started inside and one if it missed.
+   */
+  void sweep( const float*, const float*, const float*, const float*, const size_t,
+	      const clip&, unsigned char*, float* );
+
 }
 
 #endif
@@ -0,0 +1,46 @@
+#ifndef POINTS_NAMESPACE
+#define POINTS_NAMESPACE
+
+// Copyright Nick Brett 2007
+// contact nickdbrett@googlemail.com
+
+#include <cstddef>
+
+#include "vec2d.h"
+
+/**
+ * points namespace
+ *
+ * Operations on whole arrays of points, held as one array of x
+ * coordinates and one of y (as physics::clip holds its vertices)
+ * rather than as vec2ds, so that several points can be worked on at
+ * once. Four points at a time with SSE2, and one at a time otherwise
+ * or for whatever is left over. The
+ * arrays need not be aligned, nor padded beyond Count.
+ */
+namespace points
+{
+  /** move every point by the offset given */
+  void translate( float*, float*, const size_t, const vec2d& );
+
+  /** turn every point about the origin, right handed, by the angle
+      whose cosine and sine are given */
+  void rotate( float*, float*, const size_t, const float, const float );
+
+  /** as above by the angle given */
+  void rotate( float*, float*, const size_t, const float );
+
+  /** set each entry of the last array to the dot product of the
+      matching point with the vector given */
+  void dot( const float*, const float*, const size_t, const vec2d&, float* );
+
+  /** set each entry of the last array to the square of the distance
+      of the matching point from the point given */
+  void distanceSqrd( const float*, const float*, const size_t, const vec2d&, float* );
+
+  /** scale every point to unit length, points at the origin are left
+      where they are */
+  void normalise( float*, float*, const size_t );
+}
+
+#endif // POINTS_NAMESPACE
@@ -0,0 +1,70 @@
+#ifndef RANDOMSTREAM_CLASS
+#define RANDOMSTREAM_CLASS
+
+// Copyright Nick Brett 2007
+// contact nickdbrett@googlemail.com
+
+#include <stdint.h>
+#include <cstddef>
+
+/**
+ * Random Stream
+ *
+ * A small, fast pseudo random number generator, PCG32 (O'Neill). The
+ * same seed and stream give the same sequence on every machine, and
+ * streams of one seed are independent of each other, so one seed can
+ * feed every part of the game which needs chance without them
+ * disturbing each other's sequence.
+ *
+ * A stream holds no lock, each must be drawn from by one thread at a
+ * time.
+ */
+class randomStream
+{
+ public:
+  randomStream( const uint64_t Seed = 0, const uint64_t Stream = 0 )
+    {
+      this->seed( Seed,Stream );
+    }
+
+  /** restart the sequence of the seed and stream given */
+  void seed( const uint64_t Seed, const uint64_t Stream = 0 )
+    {
+      m_state     = 0;
+      m_increment = (Stream << 1) | 1;
+      this->next();
+      m_state += Seed;
+      this->next();
+    }
+
+  /** returns the next 32 bits of the sequence */
+  const uint32_t next()
+    {
+      const uint64_t old( m_state );
+
+      m_state = old * 6364136223846793005ULL + m_increment;
+
+      const uint32_t shifted( static_cast<uint32_t>( ((old >> 18) ^ old) >> 27 ) );
+      const uint32_t rotate( static_cast<uint32_t>( old >> 59 ) );
+
+      return (shifted >> rotate) | (shifted << ((-rotate) & 31));
+    }
+
+  /** returns a number in [0,1) */
+  const double uniform()
+    {
+      return this->next() * (1.0 / 4294967296.0);
+    }
+
+  /** returns a number in [0,Arg) */
+  const size_t below( const size_t Arg )
+    {
+      return static_cast<size_t>( (static_cast<uint64_t>( this->next() ) * Arg) >> 32 );
+    }
+
+ private:
+  uint64_t m_state;
+  uint64_t m_increment;
+};
+
+#endif // RANDOMSTREAM_CLASS
@@ -23,7 +23,21 @@ class shell : public particle
 	
   const shell& operator=( const shell& );
 
-  virtual void update();
+  /** defined here so that the update loop over elementManager's pool
+      of shells can inline it. The shell is moved by
+      entityStore::integrate(), which follows. */
+  virtual void update( const physics::tick& Tick )
+    {
+      m_travel += this->velocity().magnitude() * Tick.length;
+  
+      if( m_travel > m_range )
+	{
+	  this->destroy();
+	}
+	
+      return;
+    }
+
   virtual void destroy(); 
   
   virtual void draw();
@@ -36,9 +50,6 @@ class shell : public particle
   float  m_range;
   /** distance shell has traveled */
   float  m_travel;
-
-  /** time at which this was last updated */
-  physics::time_t m_updateTime;
 };
 
 #endif // SHELL_CLASS
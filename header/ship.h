@@ -31,7 +31,8 @@ class weapon
 	
   const weapon& operator=( const weapon& );
 
-  void fire( const shape* );
+  /** fire if the weapon has reloaded by the time given */
+  void fire( const shape*,const physics::time_t );
 	
  private:
   float m_muzzel_velocity;
@@ -60,7 +61,7 @@ class ship : public shape
   const ship& operator=( const ship& ); 
 
   void goRemote() { m_kind = kREMOTE; }
-  virtual void update();
+  virtual void update( const physics::tick& );
   virtual void draw();
   //  virtual void draw( const vec2d& );
 
@@ -82,9 +83,6 @@ class ship : public shape
   /** ship is invunrable for some short time after construction */
   physics::time_t m_invunrableTime;
 
-  /** time at which this was last updated */
-  physics::time_t m_updateTime;
-
   pthread_mutex_t m_mutex;
 };
 
@@ -108,7 +106,12 @@ class rock : public shape
 	
   const rock& operator=( const rock& );
 
-  virtual void update();
+  /** rocks just drift and spin, which entityStore::integrate() does */
+  virtual void update( const physics::tick& )
+    {
+      return;
+    }
+
   virtual void destroy();
 	
   const size_t size() const
@@ -118,12 +121,19 @@ class rock : public shape
 
     static int rockCount();
 
- private:
-  size_t m_size;
+  /** rocks of each size up to kLargest pick one of kOutlines
+      outlines made for that size, larger ones are given their own */
+  enum { kLargest = 4, kOutlines = 16 };
+
+  /** make the outlines shared by rocks, if they have not been made
+      already. Called at startup, or else by the first rock. */
+  static void makeOutlines();
 
-  /** time at which this was last updated */
-  physics::time_t m_updateTime;
+ private:
+  /** returns an outline for a rock of the size given */
+  static const physics::clip::ptr outline( const size_t );
 
+  size_t m_size;
 };
 
 /**
@@ -143,16 +153,13 @@ class turret : public shape
 
   const turret& operator=( const turret& );
 
-  virtual void update();
+  virtual void update( const physics::tick& );
   virtual void destroy();
 
  private:
   control::ptr m_control;
   weapon*      m_weapon;
   float        m_rot;
-
-  /** time at which this was last updated */
-  physics::time_t m_updateTime;
 };
 
 std::vector<active::ptr>& generateRocks( const size_t, std::vector<active::ptr>& );
@@ -2,6 +2,12 @@
 //         		 -> Nick Brett 08-06-03
 //
 // Layout heavly modified on 13-02-05 but implimentation of most functions remains unchanged
+//
+// Defined wholly here so that every use can be inlined. The copy
+// constructor, assignment and destructor are the compiler's own, so
+// the class is trivially copyable: an array of vec2ds is an array of
+// x,y pairs of floats which may be copied with memcpy. Operations on
+// whole arrays of points are in points.h.
 
 #ifndef VEC2D_CLASS
 #define VEC2D_CLASS
@@ -18,12 +24,23 @@ using std::endl;
 class vec2d
 {
  public: 	
-  vec2d();
-  vec2d( const float, const float );
-  vec2d( const vec2d& arg );
-  ~vec2d();
+  constexpr vec2d():
+    m_x(0.0),
+       m_y(0.0)
+  {}
+
+  constexpr vec2d( const float X, const float Y ):
+    m_x(X),
+       m_y(Y)
+  {}
 
-  const vec2d& polar( const float, const float );
+  const vec2d& polar( const float Angle, const float R )
+    {
+      m_x = R*sin(Angle);
+      m_y = R*cos(Angle);
+
+      return *this;
+    }
 
   const vec2d& set( const float X, const float Y )
     {
@@ -47,12 +64,12 @@ class vec2d
       return;
     }
 
-  const float x() const
+  constexpr const float x() const
     {
       return m_x;
     }
 
-  const float y() const
+  constexpr const float y() const
     {
       return m_y;
     }
@@ -67,37 +84,128 @@ class vec2d
       return m_y;
     }
 
-  const vec2d& operator=( const vec2d& );
-  const vec2d& operator+=( const vec2d& );
-  const vec2d& operator-=( const vec2d& );
-  const vec2d& operator*=( const float );
-  const vec2d& operator/=( const float );
+  const vec2d& operator+=( const vec2d& Rhs )
+    {
+      m_x += Rhs.m_x;
+      m_y += Rhs.m_y;
+
+      return *this;
+    }
+
+  const vec2d& operator-=( const vec2d& Rhs )
+    {
+      m_x -= Rhs.m_x;
+      m_y -= Rhs.m_y;
+
+      return *this;
+    }
+
+  const vec2d& operator*=( const float Arg )
+    {
+      m_x *= Arg;
+      m_y *= Arg;
+
+      return *this;
+    }
+
+  const vec2d& operator/=( const float Arg )
+    {
+      m_x /= Arg;
+      m_y /= Arg;
+
+      return *this;
+    }
 
-  const vec2d  operator+( const vec2d& ) const;
-  const vec2d  operator-( const vec2d& ) const;
-  const vec2d  operator*( const float ) const;
-  const vec2d  operator/( const float ) const;
+  constexpr const vec2d operator+( const vec2d& Rhs ) const
+    {
+      return vec2d( m_x+Rhs.m_x, m_y+Rhs.m_y );
+    }
 
-  const vec2d cross( const vec2d& ) const;
-  const float magnitude() const;
-  const float magSqrd() const;
+  constexpr const vec2d operator-( const vec2d& Rhs ) const
+    {
+      return vec2d( m_x-Rhs.m_x, m_y-Rhs.m_y );
+    }
+
+  constexpr const vec2d operator*( const float Rhs ) const
+    {
+      return vec2d( m_x*Rhs, m_y*Rhs );
+    }
+
+  constexpr const vec2d operator/( const float Rhs ) const
+    {
+      return vec2d( m_x/Rhs, m_y/Rhs );
+    }
+
+  constexpr const vec2d cross( const vec2d& Rhs ) const
+    {
+      return vec2d( m_x*Rhs.m_y, -m_y*Rhs.m_x );
+    }
+
+  const float magnitude() const
+    {
+      return sqrt( m_x*m_x + m_y*m_y );
+    }
+
+  constexpr const float magSqrd() const
+    {
+      return (m_x*m_x + m_y*m_y);
+    }
 	
   /** Assumes right handed rotation */
-  const vec2d& rotate( const float );
+  const vec2d& rotate( const float Angle )
+    {
+      return this->rotate( cos(Angle),sin(Angle) );
+    }
+
+  /** as above by the angle whose cosine and sine are given, so that
+      they need only be found once to turn many vectors */
+  const vec2d& rotate( const float Cos, const float Sin )
+    {
+      const float x( m_x );
+
+      m_x = x*Cos - m_y*Sin;
+      m_y = x*Sin + m_y*Cos;
+
+      return *this;
+    }
 
   /** Assumes right handed rotation */
-  const vec2d& rotate( const float, const vec2d& );
+  const vec2d& rotate( const float Angle, const vec2d& Center )
+    {
+      vec2d tmp( *this - Center );
+      tmp.rotate( Angle );
+      *this = tmp + Center;
+
+      return *this;
+    }
 	
-  const bool operator!=( const vec2d& ) const;
-  const bool operator==( const vec2d& ) const;
+  constexpr const bool operator!=( const vec2d& Rhs ) const
+    {
+      return (m_x != Rhs.m_x) || (m_y != Rhs.m_y);
+    }
+
+  constexpr const bool operator==( const vec2d& Rhs ) const
+    {
+      return (m_x == Rhs.m_x) && (m_y == Rhs.m_y);
+    }
 
   /** inverts the sign of the arguments X component. Returns a reference
       to the arg.*/
-  const vec2d& invertX();
+  const vec2d& invertX()
+    {
+      m_x = -m_x;
+
+      return *this;
+    }
 
   /** inverts the sign of the arguments Y component. Returns a reference
       to the arg.*/
-  const vec2d& invertY();
+  const vec2d& invertY()
+    {
+      m_y = -m_y;
+
+      return *this;
+    }
 
 	
  private:
@@ -110,21 +218,45 @@ class vec2d
  * Returns a copy of the argument with the sign of all elements of the
  * vector inverted
  */
-const vec2d operator-( const vec2d& );
+constexpr inline const vec2d operator-( const vec2d& Arg )
+{
+  return vec2d( -Arg.x(), -Arg.y() );
+}
 
 /** returns a vector with the same direction as the arg but with unit
     length */
-const vec2d normalise( const vec2d& );
+inline const vec2d normalise( const vec2d& Arg )
+{
+  return Arg / Arg.magnitude();
+}
 
 /** returns the dot product of the two vectors */
-const float dot( const vec2d&, const vec2d& );
+constexpr inline const float dot( const vec2d& Lhs, const vec2d& Rhs )
+{
+  return (Lhs.x()*Rhs.x()) + (Lhs.y()*Rhs.y());
+}
 
 /** returns the arguement rotated through pi/2 (right handed)*/
-const vec2d perpendicular( const vec2d& );
+constexpr inline const vec2d perpendicular( const vec2d& Arg )
+{
+  return vec2d( -Arg.y(), Arg.x() );
+}
 
 /** finds the angle between two vectors */
-const float angle( const vec2d&,const vec2d& );
+inline const float angle( const vec2d& A,const vec2d& B )
+{
+  return acos( dot(A,B)/( sqrt( A.magSqrd()*B.magSqrd() ) ) );
+}
 
-ostream& operator<<(ostream& out, const vec2d& vector);
+inline ostream& operator<<( ostream& Out, const vec2d& Vector )
+{
+  Out << "("
+      << Vector.x()
+      << ","
+      << Vector.y()
+      << ")";
+		
+  return Out;
+}
 
 #endif // VEC2D_CLASS
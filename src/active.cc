@@ -7,24 +7,221 @@
 // move about etc.
 
 #include "active.h"
+#include "lock.h"
 
 //<-- active class -->
 active::active( const vec2d& Position ):
-  item(Position)
+  item(Position),
+  m_proxy(0)
 {}
 
 active::active( const vec2d& Position,const vec2d& Velocity ):
-  item( Position,Velocity )
+  item( Position,Velocity ),
+  m_proxy(0)
 {}
 
+// a copy is not known to the broad phase until it is inserted
 active::active( const active& Arg ):
-  item(Arg)
+  item(Arg),
+  m_proxy(0)
 {}
 
 active::~active()
 {}
 
-const physics::collision collide( active* A, active* B )
+// the broad phase handle belongs to this object, not to Arg
+const active& active::operator=( const active& Arg )
+{
+  (*this).item::operator=(Arg);
+
+  return *this;
+}
+
+// <-- collision dispatch -->
+namespace
+{
+  typedef const physics::collision (*collider)( active*, active*, const vec2d& );
+  typedef void (*resolver)( active*, active*, const vec2d& );
+
+  /** the class in the active hierarchy which describes the body of
+      items with each tag, void for those with no body */
+  template< int Tag > struct bodyOf                      { typedef void     type; };
+  template<> struct bodyOf<entityStore::kShape>          { typedef shape    type; };
+  template<> struct bodyOf<entityStore::kRock>           { typedef shape    type; };
+  template<> struct bodyOf<entityStore::kShip>           { typedef shape    type; };
+  template<> struct bodyOf<entityStore::kTurret>         { typedef shape    type; };
+  template<> struct bodyOf<entityStore::kParticle>       { typedef particle type; };
+  template<> struct bodyOf<entityStore::kShell>          { typedef particle type; };
+
+  template< typename T > struct isShape                  { enum { value = false }; };
+  template<> struct isShape<shape>                       { enum { value = true }; };
+
+  /**
+   * Narrow phase and resolution for a pair of bodies. Pairs which
+   * never collide have no functions, the general case.
+   */
+  template< typename A, typename B > struct dispatch
+  {
+    static const collider collide()
+      {
+	return NULL;
+      }
+
+    static const resolver resolve()
+      {
+	return NULL;
+      }
+  };
+
+  template<> struct dispatch<shape,shape>
+  {
+    static const physics::collision narrowPhase( active* A, active* B, const vec2d& Offset )
+      {
+	return collideWithShape( static_cast<shape*>(A),static_cast<shape*>(B),Offset );
+      }
+
+    static void resolution( active* A, active* B, const vec2d& Location )
+      {
+	resolveCollisionWithShape( static_cast<shape*>(A),static_cast<shape*>(B),Location );
+      }
+
+    static const collider collide()
+      {
+	return &narrowPhase;
+      }
+
+    static const resolver resolve()
+      {
+	return &resolution;
+      }
+  };
+
+  template<> struct dispatch<shape,particle>
+  {
+    static const physics::collision narrowPhase( active* A, active* B, const vec2d& Offset )
+      {
+	return collideWithParticle( static_cast<shape*>(A),static_cast<particle*>(B),Offset );
+      }
+
+    static void resolution( active* A, active* B, const vec2d& Location )
+      {
+	resolveCollisionWithParticle( static_cast<shape*>(A),static_cast<particle*>(B),Location );
+      }
+
+    static const collider collide()
+      {
+	return &narrowPhase;
+      }
+
+    static const resolver resolve()
+      {
+	return &resolution;
+      }
+  };
+
+  template<> struct dispatch<particle,shape>
+  {
+    // moving B by Offset is the same as moving A the other way
+    static const physics::collision narrowPhase( active* A, active* B, const vec2d& Offset )
+      {
+	return collideWithParticle( static_cast<shape*>(B),static_cast<particle*>(A),-Offset );
+      }
+
+    static void resolution( active* A, active* B, const vec2d& Location )
+      {
+	resolveCollisionWithParticle( static_cast<shape*>(B),static_cast<particle*>(A),Location );
+      }
+
+    static const collider collide()
+      {
+	return &narrowPhase;
+      }
+
+    static const resolver resolve()
+      {
+	return &resolution;
+      }
+  };
+
+  /**
+   * Dispatch Table
+   *
+   * The narrow phase and resolution for every pair of tags, filled
+   * in at start up from the dispatch specialisations.
+   */
+  class dispatchTable
+    {
+    public:
+      dispatchTable();
+
+      const collider collide( const size_t A, const size_t B ) const
+	{
+	  return m_collide[A][B];
+	}
+
+      const resolver resolve( const size_t A, const size_t B ) const
+	{
+	  return m_resolve[A][B];
+	}
+
+      const bool hasShape( const size_t Arg ) const
+	{
+	  return m_hasShape[Arg];
+	}
+
+      template< int A, int B > void set()
+	{
+	  typedef dispatch< typename bodyOf<A>::type,typename bodyOf<B>::type > pair;
+
+	  m_collide[A][B] = pair::collide();
+	  m_resolve[A][B] = pair::resolve();
+	  m_hasShape[A]   = isShape< typename bodyOf<A>::type >::value;
+	}
+
+    private:
+      collider m_collide[entityStore::kTagCount][entityStore::kTagCount];
+      resolver m_resolve[entityStore::kTagCount][entityStore::kTagCount];
+      bool     m_hasShape[entityStore::kTagCount];
+    };
+
+  /** visits every pair of tags in turn */
+  template< int A, int B > struct fill
+  {
+    static void into( dispatchTable& Table )
+      {
+	Table.set<A,B>();
+	fill<A,B+1>::into( Table );
+      }
+  };
+
+  template< int A > struct fill<A,entityStore::kTagCount>
+  {
+    static void into( dispatchTable& Table )
+      {
+	fill<A+1,0>::into( Table );
+      }
+  };
+
+  template<> struct fill<entityStore::kTagCount,0>
+  {
+    static void into( dispatchTable& )
+      {}
+  };
+
+  dispatchTable::dispatchTable()
+    {
+      fill<0,0>::into( *this );
+    }
+
+  const dispatchTable s_dispatch;
+}
+
+const bool hasShape( const entityStore::tag_t Tag )
+{
+  return s_dispatch.hasShape( Tag );
+}
+
+const physics::collision collide( active* A, active* B, const vec2d& Offset )
 {
   physics::collision result;
  
@@ -34,41 +231,178 @@ const physics::collision collide( active* A, active* B )
       return result;
     }
 
+  // nor do some pairs of types, particles with particles for one
+  const collider narrowPhase( s_dispatch.collide( A->tag(),B->tag() ) );
+
+  if( narrowPhase == NULL )
+    {
+      return result;
+    }
  
   // test radi - are combined radi smaller than separation between
   // bodies ? if so no collision occurs, return.
-  if( (A->radiusSqrd() + B->radiusSqrd()) < (A->position() - B->position()).magSqrd() )
+  if( (A->radiusSqrd() + B->radiusSqrd()) < (A->position() - (B->position() + Offset)).magSqrd() )
     {
       return result;
     }
-  
-  particle* particleA( dynamic_cast<particle*>(A) );
-  particle* particleB( dynamic_cast<particle*>(B) );
 
-  if( (particleA != NULL) && (particleB != NULL) )
+  return narrowPhase( A,B,Offset );
+}
+
+namespace
+{
+  /** the particles to be tested against shapes by one call to
+      collide( pairs ), gathered by shape */
+  struct pointBatch
+  {
+    struct entry
     {
-      // particle's don't collide atm, do nothing
-    }
-  else if( particleA != NULL )
+      const shape* target;
+      size_t       pair;
+      vec2d        start;
+      vec2d        point;
+
+      const bool operator<( const entry& Arg ) const
+	{
+	  return (target < Arg.target) || ((target == Arg.target) && (pair < Arg.pair));
+	}
+    };
+
+    std::vector<entry>         entries;
+    std::vector<float>         x0;
+    std::vector<float>         y0;
+    std::vector<float>         x;
+    std::vector<float>         y;
+    std::vector<unsigned char> hits;
+    std::vector<float>         times;
+  };
+
+  /** one per thread, kept so that its vectors need not be
+      allocated again. Never freed. */
+  __thread pointBatch* s_batch = NULL;
+}
+
+void collide( const collisionPair* Pairs, const size_t Count, physics::collision* Results )
+{
+  if( s_batch == NULL )
     {
-      result = collideWithParticle( dynamic_cast<shape*>(B),particleA );
+      s_batch = new pointBatch();
     }
-  else if( particleB != NULL )
+
+  pointBatch& batch( *s_batch );
+  batch.entries.clear();
+
+  for( size_t i(0); i<Count; ++i )
     {
-      result = collideWithParticle( dynamic_cast<shape*>(A),particleB );      
+      active* A( Pairs[i].first );
+      active* B( Pairs[i].second );
+
+      Results[i] = physics::collision();
+
+      // the same tests as collide( A,B )
+      if( A == B )
+	continue;
+
+      const collider narrowPhase( s_dispatch.collide( A->tag(),B->tag() ) );
+
+      if( narrowPhase == NULL )
+	continue;
+
+      if( (A->radiusSqrd() + B->radiusSqrd()) < (A->position() - (B->position() + Pairs[i].offset)).magSqrd() )
+	continue;
+
+      // a shape and a particle are put aside to be tested with the
+      // other particles near that shape
+      const bool shapeA( s_dispatch.hasShape( A->tag() ) );
+      const bool shapeB( s_dispatch.hasShape( B->tag() ) );
+
+      if( shapeA != shapeB )
+	{
+	  pointBatch::entry entry;
+
+	  entry.pair = i;
+
+	  // the particle is swept through the shape where it stands,
+	  // as if only the particle had moved
+	  if( shapeA )
+	    {
+	      entry.target = static_cast<shape*>(A);
+	      entry.point  = B->position() + Pairs[i].offset;
+	      entry.start  = entry.point - Pairs[i].motion;
+	    }
+	  else
+	    {
+	      entry.target = static_cast<shape*>(B);
+	      entry.point  = A->position() - Pairs[i].offset;
+	      entry.start  = entry.point + Pairs[i].motion;
+	    }
+
+	  batch.entries.push_back( entry );
+	  continue;
+	}
+
+      Results[i] = narrowPhase( A,B,Pairs[i].offset );
     }
-  else
+
+  std::sort( batch.entries.begin(), batch.entries.end() );
+
+  // then each shape against all of its particles at once
+  size_t begin(0);
+
+  while( begin < batch.entries.size() )
     {
-      result = collideWithShape( dynamic_cast<shape*>(A),dynamic_cast<shape*>(B) );
+      const shape* target( batch.entries[begin].target );
+      size_t       end( begin );
+
+      batch.x0.clear();
+      batch.y0.clear();
+      batch.x.clear();
+      batch.y.clear();
+
+      for(; (end < batch.entries.size()) && (batch.entries[end].target == target); ++end )
+	{
+	  batch.x0.push_back( batch.entries[end].start.x() );
+	  batch.y0.push_back( batch.entries[end].start.y() );
+	  batch.x.push_back( batch.entries[end].point.x() );
+	  batch.y.push_back( batch.entries[end].point.y() );
+	}
+
+      batch.hits.resize( end - begin );
+      batch.times.resize( end - begin );
+      physics::sweep( &batch.x0[0], &batch.y0[0], &batch.x[0], &batch.y[0], end - begin,
+		      target->placed(), &batch.hits[0], &batch.times[0] );
+
+      for( size_t k(begin); k<end; ++k )
+	{
+	  if( batch.hits[k - begin] )
+	    {
+	      const pointBatch::entry& Entry( batch.entries[k] );
+	      const float              time( batch.times[k - begin] );
+
+	      // where the particle first touched the shape
+	      Results[ Entry.pair ] = physics::collision( Entry.start + ((Entry.point - Entry.start) * time), time );
+	    }
+	}
+
+      begin = end;
     }
 
-  return result;
+  return;
 }
 
-void resolveCollision( active::ptr A,active::ptr B,const vec2d& Location )
+void resolveCollision( const contact& Contact )
 {
-  A->destroy();
-  B->destroy();
+  if( Contact.first->destroyed() || Contact.second->destroyed() )
+    {
+      return;
+    }
+
+  const resolver resolution( s_dispatch.resolve( Contact.firstTag,Contact.secondTag ) );
+
+  if( resolution != NULL )
+    {
+      resolution( Contact.first,Contact.second,Contact.location );
+    }
   
   return;
 }
@@ -77,18 +411,45 @@ void resolveCollision( active::ptr A,active::ptr B,const vec2d& Location )
 //<-- shape class -->
 shape::shape( const vec2d& Position, const physics::clip& Clip ): 
   active(Position),
-     m_clip(Clip)
-{}
+     m_clip(new physics::clip(Clip)),
+     m_placed(),
+     m_placedTick(kStale),
+     m_placing(PTHREAD_MUTEX_INITIALIZER)
+{
+  this->setTag( entityStore::kShape );
+  this->setRadiusSqrd( m_clip->radiusSqrd() );
+}
 
 shape::shape(const vec2d& Position,const vec2d& Velocity,
 	       const physics::clip& Clip ): 
   active( Position,Velocity ),
-     m_clip(Clip)
-{}
+     m_clip(new physics::clip(Clip)),
+     m_placed(),
+     m_placedTick(kStale),
+     m_placing(PTHREAD_MUTEX_INITIALIZER)
+{
+  this->setTag( entityStore::kShape );
+  this->setRadiusSqrd( m_clip->radiusSqrd() );
+}
+
+shape::shape(const vec2d& Position,const vec2d& Velocity,
+	       const physics::clip::ptr& Clip ): 
+  active( Position,Velocity ),
+     m_clip(Clip),
+     m_placed(),
+     m_placedTick(kStale),
+     m_placing(PTHREAD_MUTEX_INITIALIZER)
+{
+  this->setTag( entityStore::kShape );
+  this->setRadiusSqrd( m_clip->radiusSqrd() );
+}
 
 shape::shape( const shape& Arg ):
   active( Arg ),
-     m_clip(Arg.box())
+     m_clip(Arg.m_clip),
+     m_placed(),
+     m_placedTick(kStale),
+     m_placing(PTHREAD_MUTEX_INITIALIZER)
 {}
 
 shape::~shape()
@@ -97,57 +458,67 @@ shape::~shape()
     {}
   catch(...)
     {}
+  pthread_mutex_destroy(&m_placing);
 }	
 
 const shape& shape::operator=( const shape& Arg )
 {
   (*this).active::operator=(Arg);
 
-  this->m_clip = Arg.box();
+  this->m_clip = Arg.m_clip;
+  this->setRadiusSqrd( m_clip->radiusSqrd() );
+  this->moved();
 
   return *this;
 }
 
-const float shape::radiusSqrd() const
+const physics::clip& shape::placed() const
 {
-  return m_clip.radiusSqrd();
+  const size_t tick( entityStore::create()->tick() );
+
+  // the first thread to find it out of date builds it while the
+  // others wait
+  if( __atomic_load_n( &m_placedTick,__ATOMIC_ACQUIRE ) != tick )
+    {
+      Lock m(m_placing);
+
+      if( m_placedTick != tick )
+	{
+	  physics::transform( *m_clip, this->angleCos(), this->angleSin(), this->position(), m_placed );
+	  __atomic_store_n( &m_placedTick,tick,__ATOMIC_RELEASE );
+	}
+    }
+
+  return m_placed;
 }
 
 void shape::draw()
 {
-  physics::transform( this->box(), this->angle(), this->position() );
-
-  graphics::draw( this->box() );
-
-  this->box().reset();
+  graphics::draw( this->placed() );
 
   return;
 }
 
 void shape::draw( const vec2d& Position )
 {
-  physics::rotate( this->box(), this->angle() );
-
-  graphics::draw( this->box(),Position );
-
-  this->box().reset();
+  graphics::draw( this->placed(),Position - this->position() );
 
   return;
 }
 
 
-const physics::collision collideWithShape( shape* A, shape* B )
+const physics::collision collideWithShape( shape* A, shape* B, const vec2d& Offset )
 {
-  // test clip boxes
-  transform( A->box(), A->angle(), A->position() );
-  transform( B->box(), B->angle(), B->position() );  
-
-  physics::collision Collision( physics::collide( A->box(),B->box() ) );
+  // test clip boxes, only moving B to its image if need be
+  if( (Offset.x() == 0.0) && (Offset.y() == 0.0) )
+    {
+      return physics::collide( A->placed(),B->placed() );
+    }
 
-  A->box().reset();
-  B->box().reset();
+  physics::clip image( B->placed() );
+  physics::translate( image, Offset );
 
-  return Collision;
+  return physics::collide( A->placed(),image );
 }
 	
 void resolveCollisionWithShape( shape* A, shape* B, const vec2d& Location )
@@ -162,12 +533,20 @@ void resolveCollisionWithShape( shape* A, shape* B, const vec2d& Location )
 particle::particle( const vec2d& Position, const float Radius ):
   active(Position),
      m_radius(Radius)
-{}
+{
+  this->setTag( entityStore::kParticle );
+  this->setRadiusSqrd( m_radius*m_radius );
+  this->setSweepRadius( m_radius );
+}
 
 particle::particle( const vec2d& Position,const vec2d& Velocity,const float Radius ):
   active(Position,Velocity),
      m_radius(Radius)
-{}
+{
+  this->setTag( entityStore::kParticle );
+  this->setRadiusSqrd( m_radius*m_radius );
+  this->setSweepRadius( m_radius );
+}
 
 particle::particle( const particle& Arg ):
   active(Arg),
@@ -182,15 +561,12 @@ const particle& particle::operator=( const particle& Arg )
   (*this).active::operator=(Arg);
   
   this->m_radius = Arg.radius();
+  this->setRadiusSqrd( m_radius*m_radius );
+  this->setSweepRadius( m_radius );
 
   return *this;
 }
 
-const float particle::radiusSqrd() const
-{
-  return m_radius*m_radius;
-}
-
 void particle::draw()
 {
   graphics::drawPoint( this->position(), m_radius, 0xff, 0xff, 0xff );
@@ -205,26 +581,22 @@ void particle::draw( const vec2d& Position )
   return;
 }
 
-const physics::collision collideWithParticle( shape* Shape, particle* Particle )
+const physics::collision collideWithParticle( shape* Shape, particle* Particle, const vec2d& Offset )
 {
   physics::collision result;
 
+  const vec2d position( Particle->position() + Offset );
+
   // test radi - are combined radi smaller than separation between
   // bodies ? if so no collision occurs, return.
   if( (Particle->radius()*Particle->radius() + Shape->box().radiusSqrd()) 
-      < (Particle->position() - Shape->position()).magSqrd() )
+      < (position - Shape->position()).magSqrd() )
     {
       return result;
     }
 
   // test clip boxes
-  transform( Shape->box(), Shape->angle(), Shape->position() );  
-
-  result = physics::collide( Particle->position(),Shape->box() );
-
-  Shape->box().reset();
-
-  return result;
+  return physics::collide( position,Shape->placed() );
 }
 
 
@@ -6,6 +6,7 @@
 // to control the npc's
 
 #include "ai.h"
+#include "elementManager.h"
 
 namespace ai
 {
@@ -38,7 +39,7 @@ namespace ai
       return;
     }
 
-  void turret::update()
+  void turret::update( const physics::tick& )
     {
       ship* target( game::state::create()->player() );
       
@@ -63,6 +64,99 @@ namespace ai
       return;
     }
 
+  //<-- class pilot -->
+  pilot::pilot():
+    inputSource(),
+    m_range(150.0)
+    {}
+
+  pilot::~pilot()
+    {}
+
+  const bool pilot::finished() const
+    {
+      return false;
+    }
+
+  void pilot::poll( const physics::tick& )
+    {
+      inputState*    input( inputState::create() );
+      const active*  player( game::state::create()->player() );
+
+      input->setKeyState( SDLK_UP,false );
+      input->setKeyState( SDLK_LEFT,false );
+      input->setKeyState( SDLK_RIGHT,false );
+      input->setKeyState( SDLK_x,false );
+
+      // held for this tick only, anything kept longer would outlive
+      // the world's own reference and never be destroyed
+      elementManager::activeContainer actives;
+      elementManager::create()->localActives( &actives );
+
+      // the player may have left the world and been freed, it is only
+      // looked at once found among the population
+      const active* self( NULL );
+      const active* target( NULL );
+      float         nearest( 0.0 );
+
+      for( size_t i(0); i<actives.size(); ++i )
+	{
+	  if( actives[i].get() == player )
+	    {
+	      self = player;
+	      break;
+	    }
+	}
+
+      if( (self == NULL) || self->destroyed() )
+	return;
+
+      for( size_t i(0); i<actives.size(); ++i )
+	{
+	  const entityStore::tag_t tag( actives[i]->tag() );
+
+	  if( ((tag != entityStore::kRock) && (tag != entityStore::kTurret)) || actives[i]->destroyed() )
+	    continue;
+
+	  const float separation( (actives[i]->position() - self->position()).magSqrd() );
+
+	  if( (target == NULL) || (separation < nearest) )
+	    {
+	      target  = actives[i].get();
+	      nearest = separation;
+	    }
+	}
+
+      if( target == NULL )
+	return;
+
+      // steer as the turrets do, but fire at anything the shells
+      // would hit
+      physics::ray attackPlane( self->position(),self->position() + self->orientation() );
+      const float direction( physics::separation( attackPlane, target->position() ) );
+      const bool  ahead( dot( target->position() - self->position(),self->orientation() ) > 0.0 );
+
+      if( ahead && (direction * direction < target->radiusSqrd()) )
+	{
+	  input->setKeyState( SDLK_x,true );
+	}
+      else if( direction < 0.0 )
+	{
+	  input->setKeyState( SDLK_LEFT,true );
+	}
+      else
+	{
+	  input->setKeyState( SDLK_RIGHT,true );
+	}
+
+      if( nearest > m_range * m_range )
+	{
+	  input->setKeyState( SDLK_UP,true );
+	}
+
+      return;
+    }
+
   manager* manager::m_ptrToSelf = NULL;
 
   manager::manager():
@@ -83,7 +177,7 @@ namespace ai
     }
 
   // <-- class manager -->
-  void manager::update()
+  void manager::update( const physics::tick& Tick )
     {	
       typedef std::vector<control::ptr>::iterator iterator;
 
@@ -97,7 +191,7 @@ namespace ai
 
       for(; itr!=end;++itr )
 	{
-	  dynamic_cast<actor*>((*itr).get())->update();
+	  dynamic_cast<actor*>((*itr).get())->update( Tick );
 	}
 
 
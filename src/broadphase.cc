@@ -0,0 +1,1657 @@
+// Broadphase.cxx
+//
+// Strategies for finding the pairs of active objects which are
+// close enough to collide.
+
+#include <sys/time.h>
+
+#include "broadphase.h"
+#include "elementManager.h"
+#include "ship.h"
+#include "shell.h"
+#include "util.h"
+
+namespace broadphase
+{
+  /** smallest cell width the grid will use */
+  static const float  s_minimumCellWidth(1.0);
+
+  /** largest number of cells the grid will use along either axis */
+  static const size_t s_maximumCells(256);
+
+  /** the padded radius used for all bounds, so that rounding in sqrt
+      can never separate a pair which overlap() would accept */
+  static const float paddedRadius( const float RadiusSqrd )
+    {
+      return std::sqrt( RadiusSqrd ) * 1.001f;
+    }
+
+  /** returns true if the image of A at the offset given overlaps B */
+  static const bool overlapImage( const vec2d& PositionA, const float RadiusSqrdA, const vec2d& Offset,
+				  const vec2d& PositionB, const float RadiusSqrdB )
+    {
+      // vec2d arithmetic is out of line, this is in the inner loops
+      const float dx( (PositionA.x() + Offset.x()) - PositionB.x() );
+      const float dy( (PositionA.y() + Offset.y()) - PositionB.y() );
+
+      return overlap( RadiusSqrdA, RadiusSqrdB, (dx*dx) + (dy*dy) );
+    }
+
+  /**
+   * record a pair found to overlap across the edge of the world. The
+   * image found by the caller need not be the nearest, so the offset
+   * reported is worked out again. Pairs whose nearest image is the
+   * object itself are left to the direct test.
+   */
+  static void addWrapped( const levelBoundary& Boundary,
+			  const size_t I, const vec2d& PositionI,
+			  const size_t J, const vec2d& PositionJ,
+			  pairContainer& Pairs )
+    {
+      if( I == J )
+	return;
+
+      if( J < I )
+	{
+	  addWrapped( Boundary, J,PositionJ, I,PositionI, Pairs );
+	  return;
+	}
+
+      const vec2d offset( Boundary.image( PositionI,PositionJ ) );
+
+      if( (offset.x() == 0.0) && (offset.y() == 0.0) )
+	return;
+
+      Pairs.push_back( pair( I,J,offset ) );
+
+      return;
+    }
+
+  /** sort pairs into the order bruteForce reports them and drop any
+      found more than once */
+  static void sortPairs( pairContainer& Pairs )
+    {
+      std::sort( Pairs.begin(), Pairs.end() );
+      Pairs.erase( std::unique( Pairs.begin(), Pairs.end() ), Pairs.end() );
+
+      return;
+    }
+
+  // <-- strategy class -->
+  strategy::strategy()
+    {}
+
+  strategy::~strategy()
+    {}
+
+  // <-- bruteForce class -->
+  bruteForce::bruteForce():
+    strategy()
+    {}
+
+  bruteForce::~bruteForce()
+    {}
+
+  void bruteForce::findPairs( const container& Population, const levelBoundary& Boundary, pairContainer& Pairs )
+    {
+      Pairs.clear();
+
+      // only objects near an edge can touch across it
+      float maxRadius(0);
+
+      for( size_t i(0); i<Population.size(); ++i )
+	{
+	  maxRadius = std::max( maxRadius, paddedRadius( Population[i]->radiusSqrd() ) );
+	}
+
+      std::vector<bool> nearEdge( Population.size() );
+
+      for( size_t i(0); i<Population.size(); ++i )
+	{
+	  nearEdge[i] = Boundary.nearEdge( Population[i]->position(), paddedRadius( Population[i]->radiusSqrd() ) + maxRadius );
+	}
+
+      std::vector<vec2d> offsets;
+
+      for( size_t i(0); i<Population.size(); ++i )
+	{
+	  const active& A( *Population[i] );
+
+	  offsets.clear();
+
+	  if( nearEdge[i] )
+	    {
+	      Boundary.images( A.position(), paddedRadius( A.radiusSqrd() ) + maxRadius, offsets );
+	    }
+
+	  for( size_t j(i+1); j<Population.size(); ++j )
+	    {
+	      const active& B( *Population[j] );
+
+	      if( overlap( A.radiusSqrd(), B.radiusSqrd(), (A.position() - B.position()).magSqrd() ) )
+		{
+		  Pairs.push_back( pair(i,j) );
+		  continue;
+		}
+
+	      if( !nearEdge[j] )
+		continue;
+
+	      for( size_t o(0); o<offsets.size(); ++o )
+		{
+		  if( overlapImage( A.position(),A.radiusSqrd(),offsets[o], B.position(),B.radiusSqrd() ) )
+		    {
+		      addWrapped( Boundary, i,A.position(), j,B.position(), Pairs );
+		      break;
+		    }
+		}
+	    }
+	}
+
+      return;
+    }
+
+  // <-- uniformGrid class -->
+  uniformGrid::uniformGrid():
+    strategy(),
+    m_x(),
+    m_y(),
+    m_radiusSqrd(),
+    m_cell(),
+    m_sorted(),
+    m_start(),
+    m_columns(0),
+    m_rows(0),
+    m_offsets()
+    {}
+
+  uniformGrid::~uniformGrid()
+    {}
+
+  void uniformGrid::findPairs( const container& Population, const levelBoundary& Boundary, pairContainer& Pairs )
+    {
+      Pairs.clear();
+
+      const size_t count( Population.size() );
+
+      if( count < 2 )
+	return;
+
+      m_x.resize( count );
+      m_y.resize( count );
+      m_radiusSqrd.resize( count );
+      m_cell.resize( count );
+      m_sorted.resize( count );
+
+      // take a copy of the data the test needs
+      float maxRadiusSqrd(0);
+
+      for( size_t i(0); i<count; ++i )
+	{
+	  const active& A( *Population[i] );
+
+	  m_x[i]          = A.position().x();
+	  m_y[i]          = A.position().y();
+	  m_radiusSqrd[i] = A.radiusSqrd();
+
+	  maxRadiusSqrd = std::max( maxRadiusSqrd, m_radiusSqrd[i] );
+	}
+
+      // overlap() can only succeed when the separation is no more
+      // than sqrt(2*maxRadiusSqrd), so cells at least that wide
+      // guarantee that overlapping pairs are in neighbouring cells
+      const float width( std::max( std::sqrt( 2.0f * maxRadiusSqrd ), s_minimumCellWidth ) );
+      const vec2d& dimension( Boundary.dimension() );
+
+      m_columns = std::max( std::min( static_cast<size_t>( dimension.x() / width ), s_maximumCells ), static_cast<size_t>(1) );
+      m_rows    = std::max( std::min( static_cast<size_t>( dimension.y() / width ), s_maximumCells ), static_cast<size_t>(1) );
+
+      const float inverseWidth( m_columns / dimension.x() );
+      const float inverseHeight( m_rows / dimension.y() );
+
+      // bucket the population by cell with a counting sort, which
+      // keeps each cell in population order
+      m_start.assign( (m_columns * m_rows) + 1, 0 );
+
+      for( size_t i(0); i<count; ++i )
+	{
+	  const int column( static_cast<int>( std::floor( m_x[i] * inverseWidth ) ) );
+	  const int row( static_cast<int>( std::floor( m_y[i] * inverseHeight ) ) );
+
+	  m_cell[i] = (std::min( std::max( row,0 ),static_cast<int>(m_rows) - 1 ) * m_columns)
+	    + std::min( std::max( column,0 ),static_cast<int>(m_columns) - 1 );
+
+	  ++m_start[ m_cell[i] + 1 ];
+	}
+
+      for( size_t c(1); c<m_start.size(); ++c )
+	{
+	  m_start[c] += m_start[c-1];
+	}
+
+      std::vector<size_t> next( m_start.begin(), m_start.end() - 1 );
+
+      for( size_t i(0); i<count; ++i )
+	{
+	  m_sorted[ next[ m_cell[i] ]++ ] = i;
+	}
+
+      // test each cell against itself and the neighbours which follow
+      // it, so every pair of neighbouring cells is visited once. Cells
+      // on the edge are also tested against all of their neighbours
+      // across the edge.
+      for( size_t row(0); row<m_rows; ++row )
+	{
+	  for( size_t column(0); column<m_columns; ++column )
+	    {
+	      const size_t c( (row * m_columns) + column );
+
+	      if( m_start[c] == m_start[c+1] )
+		continue;
+
+	      this->testCell( c, c, Pairs );
+
+	      if( column + 1 < m_columns )
+		{
+		  this->testCell( c, c + 1, Pairs );
+		}
+
+	      if( row + 1 < m_rows )
+		{
+		  if( column > 0 )
+		    {
+		      this->testCell( c, c + m_columns - 1, Pairs );
+		    }
+
+		  this->testCell( c, c + m_columns, Pairs );
+
+		  if( column + 1 < m_columns )
+		    {
+		      this->testCell( c, c + m_columns + 1, Pairs );
+		    }
+		}
+
+	      if( (column > 0) && (column + 1 < m_columns) && (row > 0) && (row + 1 < m_rows) )
+		continue;
+
+	      // testWrappedCell() tries every image so each pair of cells
+	      // which neighbour across an edge need only be tested once
+	      size_t wrapped[8];
+	      size_t wrappedCount(0);
+
+	      for( int dr(-1); dr<=1; ++dr )
+		{
+		  for( int dc(-1); dc<=1; ++dc )
+		    {
+		      const int neighbourColumn( static_cast<int>(column) + dc );
+		      const int neighbourRow( static_cast<int>(row) + dr );
+
+		      if( (neighbourColumn >= 0) && (neighbourColumn < static_cast<int>(m_columns)) &&
+			  (neighbourRow >= 0) && (neighbourRow < static_cast<int>(m_rows)) )
+			continue;
+
+		      const size_t neighbour( this->wrappedCell( neighbourColumn,neighbourRow ) );
+
+		      if( neighbour >= c )
+			{
+			  wrapped[wrappedCount++] = neighbour;
+			}
+		    }
+		}
+
+	      std::sort( wrapped, wrapped + wrappedCount );
+
+	      for( size_t w(0); w<wrappedCount; ++w )
+		{
+		  if( (w > 0) && (wrapped[w] == wrapped[w-1]) )
+		    continue;
+
+		  this->testWrappedCell( c, wrapped[w], Boundary, Pairs );
+		}
+	    }
+	}
+
+      // pairs across an edge are found from both sides
+      sortPairs( Pairs );
+
+      return;
+    }
+
+  void uniformGrid::testCell( const size_t CellA, const size_t CellB, pairContainer& Pairs ) const
+    {
+      for( size_t a( m_start[CellA] ); a<m_start[CellA+1]; ++a )
+	{
+	  const size_t i( m_sorted[a] );
+
+	  // within a cell only test each pair once
+	  const size_t first( (CellA == CellB) ? a + 1 : m_start[CellB] );
+
+	  for( size_t b(first); b<m_start[CellB+1]; ++b )
+	    {
+	      const size_t j( m_sorted[b] );
+
+	      const float dx( m_x[i] - m_x[j] );
+	      const float dy( m_y[i] - m_y[j] );
+
+	      if( overlap( m_radiusSqrd[i], m_radiusSqrd[j], (dx*dx) + (dy*dy) ) )
+		{
+		  Pairs.push_back( (i < j) ? pair(i,j) : pair(j,i) );
+		}
+	    }
+	}
+
+      return;
+    }
+
+  void uniformGrid::testWrappedCell( const size_t CellA, const size_t CellB, const levelBoundary& Boundary, pairContainer& Pairs )
+    {
+      // images of objects in B within a cell of the world are the only
+      // ones which can reach A
+      const vec2d& dimension( Boundary.dimension() );
+      const float  reach( std::max( dimension.x() / m_columns, dimension.y() / m_rows ) );
+
+      for( size_t b( m_start[CellB] ); b<m_start[CellB+1]; ++b )
+	{
+	  const size_t j( m_sorted[b] );
+	  const vec2d  positionJ( m_x[j],m_y[j] );
+
+	  m_offsets.clear();
+	  Boundary.images( positionJ, reach, m_offsets );
+
+	  for( size_t o(0); o<m_offsets.size(); ++o )
+	    {
+	      const float x( m_x[j] + m_offsets[o].x() );
+	      const float y( m_y[j] + m_offsets[o].y() );
+
+	      for( size_t a( m_start[CellA] ); a<m_start[CellA+1]; ++a )
+		{
+		  const size_t i( m_sorted[a] );
+
+		  const float dx( m_x[i] - x );
+		  const float dy( m_y[i] - y );
+
+		  if( overlap( m_radiusSqrd[i], m_radiusSqrd[j], (dx*dx) + (dy*dy) ) )
+		    {
+		      addWrapped( Boundary, i,vec2d( m_x[i],m_y[i] ), j,positionJ, Pairs );
+		    }
+		}
+	    }
+	}
+
+      return;
+    }
+
+  const size_t uniformGrid::wrappedCell( const int Column, const int Row ) const
+    {
+      const int columns( m_columns );
+      const int rows( m_rows );
+
+      int column( Column );
+      int row( Row );
+
+      // crossing the left or right edge mirrors the row ...
+      if( column < 0 )
+	{
+	  column += columns;
+	  row     = rows - 1 - row;
+	}
+      else if( column >= columns )
+	{
+	  column -= columns;
+	  row     = rows - 1 - row;
+	}
+
+      // ... and crossing the top or bottom edge mirrors the column
+      if( row < 0 )
+	{
+	  row   += rows;
+	  column = columns - 1 - column;
+	}
+      else if( row >= rows )
+	{
+	  row   -= rows;
+	  column = columns - 1 - column;
+	}
+
+      return (row * columns) + column;
+    }
+
+  // <-- sweepAndPrune class -->
+  sweepAndPrune::sweepAndPrune():
+    strategy(),
+    m_proxies(),
+    m_free(),
+    m_maxRadius(0),
+    m_offsets(),
+    m_images(),
+    m_pending(),
+    m_intervals()
+    {}
+
+  sweepAndPrune::~sweepAndPrune()
+    {}
+
+  void sweepAndPrune::inserted( const active::ptr& Arg )
+    {
+      size_t id( m_proxies.size() );
+
+      if( m_free.empty() )
+	{
+	  m_proxies.push_back( proxy() );
+	}
+      else
+	{
+	  id = m_free.back();
+	  m_free.pop_back();
+	}
+
+      m_proxies[id].object = Arg.get();
+      m_proxies[id].index  = 0;
+
+      Arg->proxy() = id;
+
+      // the new interval is merged into the list by the next sweep
+      m_pending.push_back( id );
+
+      return;
+    }
+
+  void sweepAndPrune::erased( const active::ptr& Arg )
+    {
+      const size_t id( Arg->proxy() );
+
+      m_proxies[id].object = NULL;
+
+      // if the object never reached the sorted list its proxy can be
+      // reused straight away, otherwise the next sweep drops its
+      // interval and releases the proxy
+      std::vector<size_t>::iterator pending( std::find( m_pending.begin(),m_pending.end(),id ) );
+
+      if( pending != m_pending.end() )
+	{
+	  m_pending.erase( pending );
+	  m_free.push_back( id );
+	}
+
+      return;
+    }
+
+  void sweepAndPrune::clear()
+    {
+      m_proxies.clear();
+      m_free.clear();
+      m_pending.clear();
+      m_intervals.clear();
+
+      return;
+    }
+
+  const sweepAndPrune::interval sweepAndPrune::refresh( const size_t Id ) const
+    {
+      const active& A( *m_proxies[Id].object );
+
+      const float radius( paddedRadius( A.radiusSqrd() ) );
+
+      interval rtn;
+
+      rtn.x          = A.position().x();
+      rtn.y          = A.position().y();
+      rtn.radiusSqrd = A.radiusSqrd();
+      rtn.min        = rtn.x - radius;
+      rtn.max        = rtn.x + radius;
+      rtn.index      = m_proxies[Id].index;
+      rtn.proxy      = Id;
+
+      return rtn;
+    }
+
+  void sweepAndPrune::testImage( const interval& Image, const interval& Arg, const levelBoundary& Boundary, pairContainer& Pairs ) const
+    {
+      const float dx( Image.x - Arg.x );
+      const float dy( Image.y - Arg.y );
+
+      if( overlap( Image.radiusSqrd, Arg.radiusSqrd, (dx*dx) + (dy*dy) ) )
+	{
+	  const interval& Original( m_intervals[ Image.proxy ] );
+
+	  addWrapped( Boundary, Original.index,vec2d( Original.x,Original.y ), Arg.index,vec2d( Arg.x,Arg.y ), Pairs );
+	}
+
+      return;
+    }
+
+  void sweepAndPrune::findPairs( const container& Population, const levelBoundary& Boundary, pairContainer& Pairs )
+    {
+      Pairs.clear();
+
+      // note where each object sits in the population this tick
+      for( size_t i(0); i<Population.size(); ++i )
+	{
+	  m_proxies[ Population[i]->proxy() ].index = i;
+	}
+
+      // bring the intervals up to date, dropping those whose object
+      // has left the population
+      size_t kept(0);
+
+      m_maxRadius = 0;
+
+      for( size_t k(0); k<m_intervals.size(); ++k )
+	{
+	  const size_t id( m_intervals[k].proxy );
+
+	  if( m_proxies[id].object == NULL )
+	    {
+	      m_free.push_back( id );
+	      continue;
+	    }
+
+	  m_intervals[kept] = this->refresh( id );
+	  m_maxRadius = std::max( m_maxRadius, m_intervals[kept].max - m_intervals[kept].x );
+	  ++kept;
+	}
+
+      m_intervals.resize( kept );
+
+      // the list was sorted last tick and little has moved since, so
+      // an insertion sort is close to linear
+      for( size_t k(1); k<m_intervals.size(); ++k )
+	{
+	  if( !(m_intervals[k] < m_intervals[k-1]) )
+	    continue;
+
+	  const interval moving( m_intervals[k] );
+	  size_t j(k);
+
+	  for(; (j > 0) && (moving < m_intervals[j-1]); --j )
+	    {
+	      m_intervals[j] = m_intervals[j-1];
+	    }
+
+	  m_intervals[j] = moving;
+	}
+
+      // sort the new arrivals on their own and merge them in
+      if( !m_pending.empty() )
+	{
+	  const size_t middle( m_intervals.size() );
+
+	  for( size_t k(0); k<m_pending.size(); ++k )
+	    {
+	      m_intervals.push_back( this->refresh( m_pending[k] ) );
+	      m_maxRadius = std::max( m_maxRadius, m_intervals.back().max - m_intervals.back().x );
+	    }
+
+	  m_pending.clear();
+
+	  std::sort( m_intervals.begin() + middle, m_intervals.end() );
+	  std::inplace_merge( m_intervals.begin(), m_intervals.begin() + middle, m_intervals.end() );
+	}
+
+      // sweep along x, each interval is only tested against those
+      // which start before it ends
+      for( size_t a(0); a<m_intervals.size(); ++a )
+	{
+	  const interval& A( m_intervals[a] );
+
+	  for( size_t b(a+1); (b < m_intervals.size()) && !(A.max < m_intervals[b].min); ++b )
+	    {
+	      const interval& B( m_intervals[b] );
+
+	      const float dx( A.x - B.x );
+	      const float dy( A.y - B.y );
+
+	      if( overlap( A.radiusSqrd, B.radiusSqrd, (dx*dx) + (dy*dy) ) )
+		{
+		  Pairs.push_back( (A.index < B.index) ? pair(A.index,B.index) : pair(B.index,A.index) );
+		}
+	    }
+	}
+
+      // objects near the edge have images across it, sweep the images
+      // against the list. Both are sorted by min so each pair whose
+      // intervals overlap is met once, as in the sweep above.
+      m_images.clear();
+
+      for( size_t a(0); a<m_intervals.size(); ++a )
+	{
+	  const interval& A( m_intervals[a] );
+	  const vec2d     position( A.x,A.y );
+	  const float     radius( A.max - A.x );
+
+	  if( !Boundary.nearEdge( position, radius + m_maxRadius ) )
+	    continue;
+
+	  m_offsets.clear();
+	  Boundary.images( position, radius + m_maxRadius, m_offsets );
+
+	  for( size_t o(0); o<m_offsets.size(); ++o )
+	    {
+	      interval image( A );
+
+	      image.x    += m_offsets[o].x();
+	      image.y    += m_offsets[o].y();
+	      image.min   = image.x - radius;
+	      image.max   = image.x + radius;
+	      image.proxy = a;
+
+	      m_images.push_back( image );
+	    }
+	}
+
+      std::sort( m_images.begin(), m_images.end() );
+
+      size_t i(0);
+      size_t k(0);
+
+      while( (i < m_images.size()) && (k < m_intervals.size()) )
+	{
+	  if( m_images[i] < m_intervals[k] )
+	    {
+	      const interval& A( m_images[i] );
+
+	      for( size_t b(k); (b < m_intervals.size()) && !(A.max < m_intervals[b].min); ++b )
+		{
+		  this->testImage( A, m_intervals[b], Boundary, Pairs );
+		}
+
+	      ++i;
+	    }
+	  else
+	    {
+	      const interval& B( m_intervals[k] );
+
+	      for( size_t a(i); (a < m_images.size()) && !(B.max < m_images[a].min); ++a )
+		{
+		  this->testImage( m_images[a], B, Boundary, Pairs );
+		}
+
+	      ++k;
+	    }
+	}
+
+      // report pairs in the same order as bruteForce, pairs across an
+      // edge are found from both sides
+      sortPairs( Pairs );
+
+      return;
+    }
+
+  // <-- bounds helpers -->
+  static const bounds combine( const bounds& A, const bounds& B )
+    {
+      bounds rtn;
+
+      rtn.lower = vec2d( std::min( A.lower.x(),B.lower.x() ), std::min( A.lower.y(),B.lower.y() ) );
+      rtn.upper = vec2d( std::max( A.upper.x(),B.upper.x() ), std::max( A.upper.y(),B.upper.y() ) );
+
+      return rtn;
+    }
+
+  static const float perimeter( const bounds& Arg )
+    {
+      return 2.0 * ( (Arg.upper.x() - Arg.lower.x()) + (Arg.upper.y() - Arg.lower.y()) );
+    }
+
+  /** true if Inner lies entirely within Outer */
+  static const bool contains( const bounds& Outer, const bounds& Inner )
+    {
+      return (Outer.lower.x() <= Inner.lower.x()) && (Outer.lower.y() <= Inner.lower.y())
+	&& (Inner.upper.x() <= Outer.upper.x()) && (Inner.upper.y() <= Outer.upper.y());
+    }
+
+  static const bool overlap( const bounds& A, const bounds& B )
+    {
+      return !( (A.upper.x() < B.lower.x()) || (B.upper.x() < A.lower.x())
+		|| (A.upper.y() < B.lower.y()) || (B.upper.y() < A.lower.y()) );
+    }
+
+  // <-- dynamicTree class -->
+
+  /** padding added around each leaf of a dynamicTree */
+  static const float s_treeMargin(8.0);
+
+  dynamicTree::dynamicTree():
+    m_nodes(),
+    m_root(kNull),
+    m_free(kNull),
+    m_stack()
+    {}
+
+  dynamicTree::~dynamicTree()
+    {}
+
+  void dynamicTree::clear()
+    {
+      m_nodes.clear();
+      m_root = kNull;
+      m_free = kNull;
+
+      return;
+    }
+
+  const int dynamicTree::allocate()
+    {
+      if( m_free == kNull )
+	{
+	  m_nodes.push_back( node() );
+	  m_nodes.back().parent = kNull;
+
+	  m_free = m_nodes.size() - 1;
+	}
+
+      // free nodes are chained through their parent
+      const int id( m_free );
+      m_free = m_nodes[id].parent;
+
+      node& Node( m_nodes[id] );
+
+      Node.parent = kNull;
+      Node.left   = kNull;
+      Node.right  = kNull;
+      Node.height = 0;
+      Node.data   = 0;
+
+      return id;
+    }
+
+  void dynamicTree::release( const int Id )
+    {
+      m_nodes[Id].parent = m_free;
+      m_nodes[Id].height = -1;
+      m_free = Id;
+
+      return;
+    }
+
+  const int dynamicTree::insert( const bounds& Box, const size_t Data )
+    {
+      const int id( this->allocate() );
+
+      m_nodes[id].box.lower = Box.lower - vec2d( s_treeMargin,s_treeMargin );
+      m_nodes[id].box.upper = Box.upper + vec2d( s_treeMargin,s_treeMargin );
+      m_nodes[id].data      = Data;
+
+      this->insertLeaf( id );
+
+      return id;
+    }
+
+  void dynamicTree::remove( const int Leaf )
+    {
+      this->removeLeaf( Leaf );
+      this->release( Leaf );
+
+      return;
+    }
+
+  const bool dynamicTree::move( const int Leaf, const bounds& Box )
+    {
+      if( contains( m_nodes[Leaf].box,Box ) )
+	return false;
+
+      this->removeLeaf( Leaf );
+
+      m_nodes[Leaf].box.lower = Box.lower - vec2d( s_treeMargin,s_treeMargin );
+      m_nodes[Leaf].box.upper = Box.upper + vec2d( s_treeMargin,s_treeMargin );
+
+      this->insertLeaf( Leaf );
+
+      return true;
+    }
+
+  void dynamicTree::query( const bounds& Box, std::vector<size_t>& Data ) const
+    {
+      m_stack.clear();
+      m_stack.push_back( m_root );
+
+      while( !m_stack.empty() )
+	{
+	  const int id( m_stack.back() );
+	  m_stack.pop_back();
+
+	  if( id == kNull )
+	    continue;
+
+	  const node& Node( m_nodes[id] );
+
+	  if( !overlap( Node.box,Box ) )
+	    continue;
+
+	  if( Node.leaf() )
+	    {
+	      Data.push_back( Node.data );
+	    }
+	  else
+	    {
+	      m_stack.push_back( Node.left );
+	      m_stack.push_back( Node.right );
+	    }
+	}
+
+      return;
+    }
+
+  void dynamicTree::insertLeaf( const int Leaf )
+    {
+      if( m_root == kNull )
+	{
+	  m_root = Leaf;
+	  m_nodes[Leaf].parent = kNull;
+
+	  return;
+	}
+
+      // walk down the tree choosing the child which grows least by
+      // adding the new leaf, stop when making a new parent here is
+      // cheaper than descending further
+      const bounds box( m_nodes[Leaf].box );
+      int index( m_root );
+
+      while( !m_nodes[index].leaf() )
+	{
+	  const node& Node( m_nodes[index] );
+
+	  const float combined( perimeter( combine( Node.box,box ) ) );
+	  const float cost( 2.0 * combined );
+	  const float inheritance( 2.0 * (combined - perimeter( Node.box )) );
+
+	  const node& Left( m_nodes[Node.left] );
+	  const node& Right( m_nodes[Node.right] );
+
+	  float costLeft( perimeter( combine( Left.box,box ) ) + inheritance );
+	  float costRight( perimeter( combine( Right.box,box ) ) + inheritance );
+
+	  if( !Left.leaf() )
+	    costLeft -= perimeter( Left.box );
+
+	  if( !Right.leaf() )
+	    costRight -= perimeter( Right.box );
+
+	  if( (cost < costLeft) && (cost < costRight) )
+	    break;
+
+	  index = (costLeft < costRight) ? Node.left : Node.right;
+	}
+
+      // join the leaf and its new sibling under a new parent
+      const int sibling( index );
+      const int oldParent( m_nodes[sibling].parent );
+      const int newParent( this->allocate() );
+
+      m_nodes[newParent].parent = oldParent;
+      m_nodes[newParent].box    = combine( box,m_nodes[sibling].box );
+      m_nodes[newParent].height = m_nodes[sibling].height + 1;
+      m_nodes[newParent].left   = sibling;
+      m_nodes[newParent].right  = Leaf;
+
+      m_nodes[sibling].parent = newParent;
+      m_nodes[Leaf].parent    = newParent;
+
+      if( oldParent == kNull )
+	{
+	  m_root = newParent;
+	}
+      else if( m_nodes[oldParent].left == sibling )
+	{
+	  m_nodes[oldParent].left = newParent;
+	}
+      else
+	{
+	  m_nodes[oldParent].right = newParent;
+	}
+
+      this->refit( m_nodes[Leaf].parent );
+
+      return;
+    }
+
+  void dynamicTree::removeLeaf( const int Leaf )
+    {
+      if( Leaf == m_root )
+	{
+	  m_root = kNull;
+
+	  return;
+	}
+
+      // replace the leaf's parent with its sibling
+      const int parent( m_nodes[Leaf].parent );
+      const int grandParent( m_nodes[parent].parent );
+      const int sibling( (m_nodes[parent].left == Leaf) ? m_nodes[parent].right : m_nodes[parent].left );
+
+      m_nodes[sibling].parent = grandParent;
+
+      if( grandParent == kNull )
+	{
+	  m_root = sibling;
+	}
+      else if( m_nodes[grandParent].left == parent )
+	{
+	  m_nodes[grandParent].left = sibling;
+	}
+      else
+	{
+	  m_nodes[grandParent].right = sibling;
+	}
+
+      this->release( parent );
+      this->refit( grandParent );
+
+      return;
+    }
+
+  void dynamicTree::refit( const int Start )
+    {
+      int Index( Start );
+
+      // balance and resize every ancestor up to the root
+      while( Index != kNull )
+	{
+	  Index = this->balance( Index );
+
+	  node& Node( m_nodes[Index] );
+
+	  Node.height = 1 + std::max( m_nodes[Node.left].height,m_nodes[Node.right].height );
+	  Node.box    = combine( m_nodes[Node.left].box,m_nodes[Node.right].box );
+
+	  Index = Node.parent;
+	}
+
+      return;
+    }
+
+  const int dynamicTree::balance( const int IndexA )
+    {
+      node& A( m_nodes[IndexA] );
+
+      if( A.leaf() || (A.height < 2) )
+	return IndexA;
+
+      const int indexB( A.left );
+      const int indexC( A.right );
+
+      node& B( m_nodes[indexB] );
+      node& C( m_nodes[indexC] );
+
+      const int difference( C.height - B.height );
+
+      // rotate C up
+      if( difference > 1 )
+	{
+	  const int indexF( C.left );
+	  const int indexG( C.right );
+
+	  node& F( m_nodes[indexF] );
+	  node& G( m_nodes[indexG] );
+
+	  C.left   = IndexA;
+	  C.parent = A.parent;
+	  A.parent = indexC;
+
+	  if( C.parent == kNull )
+	    {
+	      m_root = indexC;
+	    }
+	  else if( m_nodes[C.parent].left == IndexA )
+	    {
+	      m_nodes[C.parent].left = indexC;
+	    }
+	  else
+	    {
+	      m_nodes[C.parent].right = indexC;
+	    }
+
+	  // the taller of C's children stays with C
+	  if( F.height > G.height )
+	    {
+	      C.right  = indexF;
+	      A.right  = indexG;
+	      G.parent = IndexA;
+
+	      A.box = combine( B.box,G.box );
+	      C.box = combine( A.box,F.box );
+
+	      A.height = 1 + std::max( B.height,G.height );
+	      C.height = 1 + std::max( A.height,F.height );
+	    }
+	  else
+	    {
+	      C.right  = indexG;
+	      A.right  = indexF;
+	      F.parent = IndexA;
+
+	      A.box = combine( B.box,F.box );
+	      C.box = combine( A.box,G.box );
+
+	      A.height = 1 + std::max( B.height,F.height );
+	      C.height = 1 + std::max( A.height,G.height );
+	    }
+
+	  return indexC;
+	}
+
+      // rotate B up
+      if( difference < -1 )
+	{
+	  const int indexD( B.left );
+	  const int indexE( B.right );
+
+	  node& D( m_nodes[indexD] );
+	  node& E( m_nodes[indexE] );
+
+	  B.left   = IndexA;
+	  B.parent = A.parent;
+	  A.parent = indexB;
+
+	  if( B.parent == kNull )
+	    {
+	      m_root = indexB;
+	    }
+	  else if( m_nodes[B.parent].left == IndexA )
+	    {
+	      m_nodes[B.parent].left = indexB;
+	    }
+	  else
+	    {
+	      m_nodes[B.parent].right = indexB;
+	    }
+
+	  // the taller of B's children stays with B
+	  if( D.height > E.height )
+	    {
+	      B.right  = indexD;
+	      A.left   = indexE;
+	      E.parent = IndexA;
+
+	      A.box = combine( C.box,E.box );
+	      B.box = combine( A.box,D.box );
+
+	      A.height = 1 + std::max( C.height,E.height );
+	      B.height = 1 + std::max( A.height,D.height );
+	    }
+	  else
+	    {
+	      B.right  = indexE;
+	      A.left   = indexD;
+	      D.parent = IndexA;
+
+	      A.box = combine( C.box,D.box );
+	      B.box = combine( A.box,E.box );
+
+	      A.height = 1 + std::max( C.height,D.height );
+	      B.height = 1 + std::max( A.height,E.height );
+	    }
+
+	  return indexB;
+	}
+
+      return IndexA;
+    }
+
+  // <-- aabbTree class -->
+  aabbTree::aabbTree():
+    strategy(),
+    m_proxies(),
+    m_free(),
+    m_tree(),
+    m_hits(),
+    m_maxRadius(0),
+    m_offsets()
+    {}
+
+  aabbTree::~aabbTree()
+    {}
+
+  const bounds aabbTree::boundsOf( const active& Arg ) const
+    {
+      return circleBounds( Arg.position(), paddedRadius( Arg.radiusSqrd() ) );
+    }
+
+  void aabbTree::inserted( const active::ptr& Arg )
+    {
+      size_t id( m_proxies.size() );
+
+      if( m_free.empty() )
+	{
+	  m_proxies.push_back( proxy() );
+	}
+      else
+	{
+	  id = m_free.back();
+	  m_free.pop_back();
+	}
+
+      proxy& Proxy( m_proxies[id] );
+
+      Proxy.object     = Arg.get();
+      Proxy.index      = 0;
+      Proxy.radiusSqrd = Arg->radiusSqrd();
+      Proxy.leaf       = dynamicTree::kNull;
+
+      // only shapes go in the tree
+      if( hasShape( Arg->tag() ) )
+	{
+	  Proxy.leaf = m_tree.insert( this->boundsOf( *Arg ),id );
+	}
+
+      Arg->proxy() = id;
+
+      return;
+    }
+
+  void aabbTree::erased( const active::ptr& Arg )
+    {
+      const size_t id( Arg->proxy() );
+
+      if( m_proxies[id].leaf != dynamicTree::kNull )
+	{
+	  m_tree.remove( m_proxies[id].leaf );
+	}
+
+      m_proxies[id].object = NULL;
+      m_free.push_back( id );
+
+      return;
+    }
+
+  void aabbTree::clear()
+    {
+      m_proxies.clear();
+      m_free.clear();
+      m_tree.clear();
+
+      return;
+    }
+
+  void aabbTree::findPairs( const container& Population, const levelBoundary& Boundary, pairContainer& Pairs )
+    {
+      Pairs.clear();
+
+      m_maxRadius = 0;
+
+      // note where each object sits in the population this tick and
+      // move the shapes which have left their padded bounds
+      for( size_t i(0); i<Population.size(); ++i )
+	{
+	  proxy& Proxy( m_proxies[ Population[i]->proxy() ] );
+
+	  Proxy.index      = i;
+	  Proxy.radiusSqrd = Population[i]->radiusSqrd();
+
+	  if( Proxy.leaf != dynamicTree::kNull )
+	    {
+	      m_tree.move( Proxy.leaf,this->boundsOf( *Population[i] ) );
+	      m_maxRadius = std::max( m_maxRadius, paddedRadius( Proxy.radiusSqrd ) );
+	    }
+	}
+
+      // query the tree with every active
+      for( size_t i(0); i<Population.size(); ++i )
+	{
+	  const active& A( *Population[i] );
+	  const proxy&  Proxy( m_proxies[ A.proxy() ] );
+
+	  m_hits.clear();
+	  m_tree.query( this->boundsOf( A ),m_hits );
+
+	  for( size_t h(0); h<m_hits.size(); ++h )
+	    {
+	      const proxy& Other( m_proxies[ m_hits[h] ] );
+	      const size_t j( Other.index );
+
+	      // a pair of shapes is found from both ends, keep one
+	      if( (j == i) || ((Proxy.leaf != dynamicTree::kNull) && (j < i)) )
+		continue;
+
+	      if( overlap( Proxy.radiusSqrd, Other.radiusSqrd, (A.position() - Other.object->position()).magSqrd() ) )
+		{
+		  Pairs.push_back( (i < j) ? pair(i,j) : pair(j,i) );
+		}
+	    }
+
+	  // query again at each image across a nearby edge
+	  const float radius( paddedRadius( Proxy.radiusSqrd ) );
+
+	  if( !Boundary.nearEdge( A.position(), radius + m_maxRadius ) )
+	    continue;
+
+	  m_offsets.clear();
+	  Boundary.images( A.position(), radius + m_maxRadius, m_offsets );
+
+	  for( size_t o(0); o<m_offsets.size(); ++o )
+	    {
+	      m_hits.clear();
+	      m_tree.query( circleBounds( A.position() + m_offsets[o], radius ),m_hits );
+
+	      for( size_t h(0); h<m_hits.size(); ++h )
+		{
+		  const proxy& Other( m_proxies[ m_hits[h] ] );
+
+		  if( overlapImage( A.position(),Proxy.radiusSqrd,m_offsets[o], Other.object->position(),Other.radiusSqrd ) )
+		    {
+		      addWrapped( Boundary, i,A.position(), Other.index,Other.object->position(), Pairs );
+		    }
+		}
+	    }
+	}
+
+      // report pairs in the same order as bruteForce, pairs across an
+      // edge are found from both sides
+      sortPairs( Pairs );
+
+      return;
+    }
+
+  // <-- contactCache class -->
+  contactCache::contactCache():
+    strategy(),
+    m_proxies(),
+    m_free(),
+    m_dirty(),
+    m_slots( kSlots ),
+    m_base(0),
+    m_next(),
+    m_due(),
+    m_now(0),
+    m_step(0)
+    {}
+
+  contactCache::~contactCache()
+    {}
+
+  void contactCache::inserted( const active::ptr& Arg )
+    {
+      size_t id( m_proxies.size() );
+
+      if( m_free.empty() )
+	{
+	  m_proxies.push_back( proxy() );
+	  m_proxies[id].stamp = 0;
+	  m_proxies[id].dirty = false;
+	}
+      else
+	{
+	  id = m_free.back();
+	  m_free.pop_back();
+	}
+
+      proxy& Proxy( m_proxies[id] );
+
+      Proxy.object   = Arg.get();
+      Proxy.index    = 0;
+      Proxy.impulses = Arg->impulses();
+
+      Arg->proxy() = id;
+
+      // nothing is known about the newcomer yet. A proxy released
+      // this tick may still be waiting in m_dirty, which will do.
+      this->disturb( id );
+
+      return;
+    }
+
+  void contactCache::erased( const active::ptr& Arg )
+    {
+      const size_t id( Arg->proxy() );
+
+      // pairs still waiting in the ring go stale, the next sweep of
+      // m_dirty skips the proxy
+      m_proxies[id].object = NULL;
+      ++m_proxies[id].stamp;
+      m_free.push_back( id );
+
+      return;
+    }
+
+  void contactCache::clear()
+    {
+      m_proxies.clear();
+      m_free.clear();
+      m_dirty.clear();
+      m_next.clear();
+
+      for( size_t s(0); s<m_slots.size(); ++s )
+	{
+	  m_slots[s].clear();
+	}
+
+      return;
+    }
+
+  void contactCache::advance( const physics::time_t Now )
+    {
+      m_step = (m_now > 0.0) ? Now - m_now : 0.0;
+      m_now  = Now;
+
+      return;
+    }
+
+  void contactCache::disturb( const size_t Id )
+    {
+      proxy& Proxy( m_proxies[Id] );
+
+      if( Proxy.dirty )
+	return;
+
+      Proxy.dirty = true;
+      ++Proxy.stamp;
+      m_dirty.push_back( Id );
+
+      return;
+    }
+
+  void contactCache::schedule( const entry& Entry, const physics::time_t Time )
+    {
+      const physics::time_t slot( Time * kSlotsPerSecond );
+
+      if( slot < m_base )
+	{
+	  m_next.push_back( Entry );
+	}
+      else if( slot >= m_base + kSlots - 1 )
+	{
+	  m_slots[ (m_base + kSlots - 1) % kSlots ].push_back( Entry );
+	}
+      else
+	{
+	  m_slots[ static_cast<size_t>(slot) % kSlots ].push_back( Entry );
+	}
+
+      return;
+    }
+
+  void contactCache::test( const size_t First, const size_t Second, const levelBoundary& Boundary, pairContainer& Pairs )
+    {
+      // pairs are reported lowest population index first
+      const bool    swap( m_proxies[Second].index < m_proxies[First].index );
+      const proxy&  A( m_proxies[ swap ? Second : First ] );
+      const proxy&  B( m_proxies[ swap ? First : Second ] );
+      const vec2d&  positionA( A.object->position() );
+      const vec2d&  positionB( B.object->position() );
+
+      entry next;
+
+      next.first  = First;
+      next.second = Second;
+      next.stamps = A.stamp + B.stamp;
+
+      float separationSqrd( (positionA - positionB).magSqrd() );
+
+      if( overlap( A.radiusSqrd, B.radiusSqrd, separationSqrd ) )
+	{
+	  Pairs.push_back( pair( A.index,B.index ) );
+	  m_next.push_back( next );
+	  return;
+	}
+
+      // an image across an edge is no nearer than the sum of the
+      // distances of the two objects to the edges, so only pairs
+      // close to one need look for it
+      const float halfSeparation( std::sqrt( separationSqrd ) * 0.5f );
+
+      if( Boundary.nearEdge( positionA,halfSeparation ) || Boundary.nearEdge( positionB,halfSeparation ) )
+	{
+	  const vec2d offset( Boundary.image( positionA,positionB ) );
+
+	  if( (offset.x() != 0.0) || (offset.y() != 0.0) )
+	    {
+	      separationSqrd = (positionA - (positionB + offset)).magSqrd();
+
+	      if( overlap( A.radiusSqrd, B.radiusSqrd, separationSqrd ) )
+		{
+		  Pairs.push_back( pair( A.index,B.index,offset ) );
+		  m_next.push_back( next );
+		  return;
+		}
+	    }
+	}
+
+      // the nearest images close at no more than the sum of the
+      // speeds, mirroring at an edge leaves a speed unchanged
+      const float closing( A.speed + B.speed );
+      const float gap( std::sqrt( separationSqrd ) - A.radius - B.radius );
+
+      if( closing <= 0.0 )
+	{
+	  this->schedule( next, m_now + kSlots );
+	}
+      else
+	{
+	  this->schedule( next, m_now + (gap / closing) - m_step );
+	}
+
+      return;
+    }
+
+  void contactCache::findPairs( const container& Population, const levelBoundary& Boundary, pairContainer& Pairs )
+    {
+      Pairs.clear();
+
+      // note where each object sits in the population this tick and
+      // look for those whose motion has been changed
+      for( size_t i(0); i<Population.size(); ++i )
+	{
+	  const active& A( *Population[i] );
+	  const size_t  id( A.proxy() );
+	  proxy&        Proxy( m_proxies[id] );
+
+	  Proxy.index      = i;
+	  Proxy.radiusSqrd = A.radiusSqrd();
+	  Proxy.radius     = paddedRadius( Proxy.radiusSqrd );
+	  Proxy.speed      = A.velocity().magnitude();
+	  Proxy.shape      = hasShape( A.tag() );
+
+	  if( Proxy.impulses != A.impulses() )
+	    {
+	      Proxy.impulses = A.impulses();
+	      this->disturb( id );
+	    }
+	}
+
+      // gather the pairs which have come due
+      m_due.clear();
+      m_due.swap( m_next );
+
+      const size_t current( static_cast<size_t>( m_now * kSlotsPerSecond ) );
+
+      for( size_t s(m_base); (s <= current) && (s < m_base + kSlots); ++s )
+	{
+	  std::vector<entry>& slot( m_slots[ s % kSlots ] );
+
+	  m_due.insert( m_due.end(), slot.begin(), slot.end() );
+	  slot.clear();
+	}
+
+      m_base = std::max( m_base, current + 1 );
+
+      // predictions made before either proxy was disturbed or
+      // released no longer stand
+      for( size_t e(0); e<m_due.size(); ++e )
+	{
+	  const entry& Entry( m_due[e] );
+
+	  if( m_proxies[Entry.first].stamp + m_proxies[Entry.second].stamp != Entry.stamps )
+	    continue;
+
+	  this->test( Entry.first, Entry.second, Boundary, Pairs );
+	}
+
+      // disturbed objects meet everything afresh, a pair of them is
+      // tested from the lower proxy only
+      for( size_t d(0); d<m_dirty.size(); ++d )
+	{
+	  const size_t id( m_dirty[d] );
+
+	  if( m_proxies[id].object == NULL )
+	    continue;
+
+	  for( size_t j(0); j<Population.size(); ++j )
+	    {
+	      const size_t other( Population[j]->proxy() );
+	      const proxy& Other( m_proxies[other] );
+
+	      if( (other == id) || (Other.dirty && (other < id)) )
+		continue;
+
+	      if( !m_proxies[id].shape && !Other.shape )
+		continue;
+
+	      this->test( id, other, Boundary, Pairs );
+	    }
+	}
+
+      for( size_t d(0); d<m_dirty.size(); ++d )
+	{
+	  m_proxies[ m_dirty[d] ].dirty = false;
+	}
+
+      m_dirty.clear();
+
+      // report pairs in the same order as bruteForce
+      sortPairs( Pairs );
+
+      return;
+    }
+
+  strategy* generate( const mode_t Mode )
+    {
+      switch( Mode )
+	{
+	case kUniformGrid:
+	  return new uniformGrid();
+
+	case kSweepAndPrune:
+	  return new sweepAndPrune();
+
+	case kAabbTree:
+	  return new aabbTree();
+
+	case kContactCache:
+	  return new contactCache();
+
+	case kBruteForce:
+	default:
+	  return new bruteForce();
+	}
+    }
+
+  const mode_t mode( const std::string& Name ) throw( exception )
+    {
+      if( Name == "brute" )
+	return kBruteForce;
+
+      if( Name == "grid" )
+	return kUniformGrid;
+
+      if( Name == "sweep" )
+	return kSweepAndPrune;
+
+      if( Name == "tree" )
+	return kAabbTree;
+
+      if( Name == "cache" )
+	return kContactCache;
+
+      throw( exception( "unknown broad phase '" + Name + "', expected brute, grid, sweep, tree or cache" ) );
+    }
+
+  /** time Ticks calls to findPairs after a warm up tick, moving the
+      population between each one */
+  static const double timeStrategy( const mode_t Mode, const container& Population, const size_t Ticks )
+    {
+      const float tick( 1.0 / 60.0 );
+      const levelBoundary boundary( vec2d( 512.0,512.0 ) );
+
+      strategy* broadPhase( generate( Mode ) );
+      pairContainer pairs;
+
+      for( size_t i(0); i<Population.size(); ++i )
+	{
+	  broadPhase->inserted( Population[i] );
+	}
+
+      broadPhase->findPairs( Population, boundary, pairs );
+
+      struct timeval start;
+      struct timeval stop;
+      double total(0);
+
+      for( size_t t(0); t<Ticks; ++t )
+	{
+	  for( size_t i(0); i<Population.size(); ++i )
+	    {
+	      vec2d& position( Population[i]->position() );
+
+	      position = boundary.wrap( position + (Population[i]->velocity() * tick) );
+	    }
+
+	  broadPhase->advance( (t + 1) * tick );
+
+	  gettimeofday( &start,0 );
+	  broadPhase->findPairs( Population, boundary, pairs );
+	  gettimeofday( &stop,0 );
+
+	  total += util::timeval_subtract( stop,start );
+	}
+
+      delete broadPhase;
+
+      return total / Ticks;
+    }
+
+  void benchmark( std::ostream& Out )
+    {
+      const size_t populations[] = { 1000, 10000, 50000 };
+      const size_t ticks[]       = { 20, 5, 2 };
+      const mode_t modes[]       = { kBruteForce, kUniformGrid, kSweepAndPrune, kAabbTree, kContactCache };
+      const char*  names[]       = { "brute", "grid", "sweep", "tree", "cache" };
+
+      // the cache holds a prediction for every pair with a shape in
+      // it, more than will fit for the largest population
+      const size_t cacheLimit( 10000 );
+
+      // the same population every time
+      randomStream random(1);
+
+      for( size_t p(0); p<3; ++p )
+	{
+	  // one rock for every nineteen shells, moving at game speeds
+	  container population;
+
+	  for( size_t i(0); i<populations[p]; ++i )
+	    {
+	      const double x( 512.0 * random.uniform() );
+	      const double y( 512.0 * random.uniform() );
+	      const vec2d  position( x,y );
+	      vec2d        velocity( 0.0,1.0 );
+
+	      velocity.rotate( random.uniform() * (2.0 * M_PI) );
+
+	      if( (i % 20) == 0 )
+		{
+		  population.push_back( active::ptr( new rock( position,velocity * 10.0,1 + random.below(4) ) ) );
+		}
+	      else
+		{
+		  population.push_back( active::ptr( new shell( position,velocity * 150.0 ) ) );
+		}
+	    }
+
+	  Out << population.size() << " actives:";
+
+	  for( size_t m(0); m<5; ++m )
+	    {
+	      if( (modes[m] == kContactCache) && (population.size() > cacheLimit) )
+		continue;
+
+	      Out << "  " << names[m] << " " << timeStrategy( modes[m],population,ticks[p] ) * 1000.0 << " ms";
+	      Out.flush();
+	    }
+
+	  Out << std::endl;
+	}
+
+      return;
+    }
+}
@@ -23,7 +23,12 @@
  */
  
 #include "elementManager.h"
+#include "ship.h"
+#include "shell.h"
 #include "lock.h"
+#include "parallel.h"
+
+#include <boost/bind.hpp>
 
 levelBoundary::levelBoundary( const vec2d& Arg ):
   m_dimension(Arg),
@@ -40,36 +45,76 @@ levelBoundary::levelBoundary( const vec2d& Arg ):
 levelBoundary::~levelBoundary()
 {}
 
-void levelBoundary::remap( active::ptr Arg, std::vector< std::pair<active::ptr,vec2d> >& Container ) const
+void levelBoundary::remap( entityStore& Store ) const
 {
-  // if Arg's CoM is outside the boundary then move it inside the
-  // boundary
-  if( Arg->position().x() < 0.0 )
-    {
-      Arg->translate( vec2d( m_dimension.x(),m_dimension.y() - (Arg->position().y() * 2.0) ) );
-      Arg->velocity().invertY();
-    }
-  else if( Arg->position().x() > m_dimension.x() )
-    {
-      Arg->translate( vec2d( -m_dimension.x(),m_dimension.y() - (Arg->position().y() * 2.0) ) );
-      Arg->velocity().invertY();
-    }
+  Lock m( Store.mutex() );
 
-  if( Arg->position().y() < 0.0 )
-    {
-      Arg->translate( vec2d( m_dimension.x() - (Arg->position().x() * 2.0) ,m_dimension.y() ) );
-      Arg->velocity().invertX();
-    }
-  else if( Arg->position().y() > m_dimension.y() )
+  const float w( m_dimension.x() );
+  const float h( m_dimension.y() );
+
+  for( size_t b(0); b<Store.blockCount(); ++b )
     {
-      Arg->translate( vec2d( m_dimension.x() - (Arg->position().x() * 2.0) , -m_dimension.y() ) );
-      Arg->velocity().invertX();
+      entityStore::block& Block( Store.blockAt(b) );
+      const size_t        count( Store.used(b) );
+
+      for( size_t i(0); i<count; ++i )
+	{
+	  if( !Block.inWorld[i] )
+	    continue;
+
+	  float& x( Block.position[i].x() );
+	  float& y( Block.position[i].y() );
+
+	  // the start of the last move goes along with the position, so
+	  // the path stays whole
+	  float& px( Block.previous[i].x() );
+	  float& py( Block.previous[i].y() );
+
+	  // if the CoM is outside the boundary then move it inside the
+	  // boundary
+	  if( x < 0.0 )
+	    {
+	      x += w;
+	      y  = h - y;
+	      px += w;
+	      py  = h - py;
+	      Block.velocity[i].invertY();
+	    }
+	  else if( x > w )
+	    {
+	      x -= w;
+	      y  = h - y;
+	      px -= w;
+	      py  = h - py;
+	      Block.velocity[i].invertY();
+	    }
+
+	  if( y < 0.0 )
+	    {
+	      x  = w - x;
+	      y += h;
+	      px  = w - px;
+	      py += h;
+	      Block.velocity[i].invertX();
+	    }
+	  else if( y > h )
+	    {
+	      x  = w - x;
+	      y -= h;
+	      px  = w - px;
+	      py -= h;
+	      Block.velocity[i].invertX();
+	    }
+	}
     }
 
-  // test Arg: is it a point object or does it have a shape ?
-  shape* shapePtr( dynamic_cast<shape*>(Arg.get()) );
+  return;
+}
 
-  if( shapePtr == NULL )
+void levelBoundary::copies( const active::ptr Arg, std::vector< std::pair<active::ptr,vec2d> >& Container ) const
+{
+  // test Arg: is it a point object or does it have a shape ?
+  if( !hasShape( Arg->tag() ) )
     return;
 
   // if Arg has a shape then test whether it collides with edges
@@ -112,6 +157,140 @@ void levelBoundary::remap( active::ptr Arg, std::vector< std::pair<active::ptr,v
   return;
 }
 
+const vec2d levelBoundary::wrap( const vec2d& Arg ) const
+{
+  vec2d rtn( Arg );
+
+  if( rtn.x() < 0.0 )
+    {
+      rtn.set( rtn.x() + m_dimension.x(), m_dimension.y() - rtn.y() );
+    }
+  else if( rtn.x() > m_dimension.x() )
+    {
+      rtn.set( rtn.x() - m_dimension.x(), m_dimension.y() - rtn.y() );
+    }
+
+  if( rtn.y() < 0.0 )
+    {
+      rtn.set( m_dimension.x() - rtn.x(), rtn.y() + m_dimension.y() );
+    }
+  else if( rtn.y() > m_dimension.y() )
+    {
+      rtn.set( m_dimension.x() - rtn.x(), rtn.y() - m_dimension.y() );
+    }
+
+  return rtn;
+}
+
+/** positions of the eight images of a point around the world */
+static void imagePositions( const vec2d& Dimension, const vec2d& Arg, vec2d* Images )
+{
+  const float w( Dimension.x() );
+  const float h( Dimension.y() );
+  const float x( Arg.x() );
+  const float y( Arg.y() );
+
+  // across the left and right edges
+  Images[0].set( x + w, h - y );
+  Images[1].set( x - w, h - y );
+
+  // across the top and bottom edges
+  Images[2].set( w - x, y + h );
+  Images[3].set( w - x, y - h );
+
+  // across the corners
+  Images[4].set( -x, -y );
+  Images[5].set( (2.0 * w) - x, -y );
+  Images[6].set( -x, (2.0 * h) - y );
+  Images[7].set( (2.0 * w) - x, (2.0 * h) - y );
+
+  return;
+}
+
+const vec2d levelBoundary::image( const vec2d& From, const vec2d& To ) const
+{
+  vec2d images[8];
+  imagePositions( m_dimension, To, images );
+
+  vec2d nearest( To );
+  float separation( (From - To).magSqrd() );
+
+  for( size_t i(0); i<8; ++i )
+    {
+      const float candidate( (From - images[i]).magSqrd() );
+
+      if( candidate < separation )
+	{
+	  separation = candidate;
+	  nearest    = images[i];
+	}
+    }
+
+  return nearest - To;
+}
+
+const vec2d levelBoundary::imageVelocity( const vec2d& Position, const vec2d& Offset, const vec2d& Velocity ) const
+{
+  if( (Offset.x() == 0.0) && (Offset.y() == 0.0) )
+    return Velocity;
+
+  vec2d images[8];
+  imagePositions( m_dimension, Position, images );
+
+  // find the image the offset leads to
+  size_t nearest(0);
+  float  separation( (images[0] - Position - Offset).magSqrd() );
+
+  for( size_t i(1); i<8; ++i )
+    {
+      const float candidate( (images[i] - Position - Offset).magSqrd() );
+
+      if( candidate < separation )
+	{
+	  separation = candidate;
+	  nearest    = i;
+	}
+    }
+
+  // mirrored as in remap(), across the corners both ways
+  vec2d rtn( Velocity );
+
+  if( nearest != 2 && nearest != 3 )
+    {
+      rtn.invertY();
+    }
+
+  if( nearest >= 2 )
+    {
+      rtn.invertX();
+    }
+
+  return rtn;
+}
+
+void levelBoundary::images( const vec2d& Arg, const float Distance, std::vector<vec2d>& Container ) const
+{
+  vec2d images[8];
+  imagePositions( m_dimension, Arg, images );
+
+  for( size_t i(0); i<8; ++i )
+    {
+      if( (images[i].x() >= -Distance) && (images[i].x() <= m_dimension.x() + Distance) &&
+	  (images[i].y() >= -Distance) && (images[i].y() <= m_dimension.y() + Distance) )
+	{
+	  Container.push_back( images[i] - Arg );
+	}
+    }
+
+  return;
+}
+
+const bool levelBoundary::nearEdge( const vec2d& Arg, const float Distance ) const
+{
+  return (Arg.x() < Distance) || (Arg.x() > m_dimension.x() - Distance) ||
+    (Arg.y() < Distance) || (Arg.y() > m_dimension.y() - Distance);
+}
+
 const bool levelBoundary::overlapEdge( const active::ptr Arg, const size_t Edge ) const
 {
   float separation( physics::separation( this->edge(Edge),Arg->position() ) );
@@ -139,17 +318,47 @@ const bool levelBoundary::contains( const vec2d& Arg ) const
 }
 
 
+/** orders actives by their slot in the entityStore */
+static const bool slotOrder( const active::ptr& A, const active::ptr& B )
+{
+  return A->slot() < B->slot();
+}
+
+/** orders contacts by the time in the tick at which they were made */
+static const bool earlierContact( const contact& A, const contact& B )
+{
+  return A.time < B.time;
+}
+
+contactListener::contactListener()
+{}
+
+contactListener::~contactListener()
+{}
+
 elementManager* elementManager::m_ptrToSelf = NULL;
  
 elementManager::elementManager(): 
   m_passivePopulation(),
   m_activePopulation(),
   m_activeAddEntries(),
+  m_rocks(),
+  m_shells(),
+  m_ships(),
+  m_turrets(),
+  m_otherActives(),
   m_edgeOfScreen(),
   m_boundary( vec2d(512,512) ),
+  m_broadPhase( broadphase::generate( broadphase::kUniformGrid ) ),
+  m_candidates(),
+  m_chunks(),
+  m_events(),
+  m_listeners(),
   m_lastUpdate( physics::runTime::create()->now() ),
+  m_seed(0),
   m_mutex(PTHREAD_RECURSIVE_MUTEX_INITIALIZER_NP)
 {
+  this->seed( m_seed );
 }
  
 elementManager::~elementManager()
@@ -160,6 +369,7 @@ elementManager::~elementManager()
     }
   catch(...)
     {}
+  delete m_broadPhase;
   pthread_mutex_destroy(&m_mutex);
 }
 	
@@ -210,9 +420,23 @@ void elementManager::insert( passive::ptr Arg )
 void elementManager::erase(active* Arg)				// Remove elements from game world
 {
   Lock m(m_mutex);
-  m_activePopulation.erase( remove( m_activePopulation.begin(),
-				    m_activePopulation.end(),active::ptr(Arg) ),
-			    m_activePopulation.end() );
+
+  // compare raw pointers, a second shared_ptr to Arg would delete it
+  std::vector<active::ptr>::iterator itr( m_activePopulation.begin() );
+  std::vector<active::ptr>::iterator end( m_activePopulation.end() );
+
+  for(; itr!=end; ++itr )
+    {
+      if( itr->get() == Arg )
+	{
+	  m_broadPhase->erased( *itr );
+	  (*itr)->inWorld() = false;
+	  this->eraseFromPool( itr->get() );
+	  m_activePopulation.erase( itr );
+
+	  break;
+	}
+    }
 
   return;
 }
@@ -271,36 +495,193 @@ void elementManager::clear()
 {
   Lock m(m_mutex);
   m_passivePopulation.clear();
+
+  // some of the population may be held elsewhere and outlive the world
+  std::vector<active::ptr>::iterator itr( m_activePopulation.begin() );
+  std::vector<active::ptr>::iterator end( m_activePopulation.end() );
+
+  for(; itr!=end; ++itr )
+    {
+      (*itr)->inWorld() = false;
+    }
+
   m_activePopulation.clear(); 
+  m_rocks.clear();
+  m_shells.clear();
+  m_ships.clear();
+  m_turrets.clear();
+  m_otherActives.clear();
   m_activeAddEntries.clear(); 
   m_edgeOfScreen.clear();     
+  m_broadPhase->clear();
   
   return;
 }
 	
-void elementManager::update()
+void elementManager::update( const physics::tick& Tick )
 {	
   Lock m(m_mutex);
-  // update all active objects held in population
-  for_each( m_activePopulation.begin(),m_activePopulation.end(),mem_fun_ptr<active,void>( &active::update ) );
+  entityStore* store( entityStore::create() );
+
+  parallel::workers* workers( parallel::workers::create() );
+
+  // update all active objects held in the pools, one type at a time,
+  // shared between the worker threads. Objects they add to the world
+  // and the like are held back until every chunk is done. Actives of
+  // other types may not be safe to update together so they follow on
+  // this thread alone.
+  const size_t poolMembers( m_shells.size() + m_rocks.size() + m_ships.size() + m_turrets.size() );
+
+  workers->forEach( poolMembers, kUpdateGrain, boost::bind( &elementManager::updatePools, this, boost::cref(Tick), _1, _2 ) );
+
+  for( size_t i(0); i<m_otherActives.size(); ++i )
+    {
+      m_otherActives[i]->update( Tick );
+    }
+
+  // then move them all in one pass through the store, a block to each
+  // thread
+  {
+    Lock s( store->mutex() );
+
+    workers->forEach( store->blockCount(), 1, boost::bind( &entityStore::integrate, store, boost::cref(Tick), _1, _2 ) );
+
+    m_broadPhase->advance( Tick.now );
+  }
   
-  // remove destroyed elements
+  // last tick's contacts refer to actives which may be about to go
+  m_events.clear();
+
+  // remove destroyed elements, letting the broad phase know first
+  std::vector<active::ptr>::iterator itr( m_activePopulation.begin() );
+  std::vector<active::ptr>::iterator end( m_activePopulation.end() );
+
+  for(; itr!=end; ++itr )
+    {
+      if( (*itr)->destroyed() )
+	{
+	  m_broadPhase->erased( *itr );
+	  (*itr)->inWorld() = false;
+	}
+    }
+
+  m_shells.prune();
+  m_rocks.prune();
+  m_ships.prune();
+  m_turrets.prune();
+  m_otherActives.erase( remove_if( m_otherActives.begin(),m_otherActives.end(),std::mem_fun( &active::destroyed ) ),
+			m_otherActives.end() );
+
   m_activePopulation.erase( remove_if( m_activePopulation.begin(),m_activePopulation.end(), destroyed<active>() ), 
 			    m_activePopulation.end() );
 
-  // add new elements to active population
-  copy( m_activeAddEntries.rbegin(),m_activeAddEntries.rend(), back_inserter(m_activePopulation) );
+  // add new elements to active population, keeping it in slot order
+  const size_t middle( m_activePopulation.size() );
+  std::vector<active::ptr>::reverse_iterator entry( m_activeAddEntries.rbegin() );
+
+  for(; entry!=m_activeAddEntries.rend(); ++entry )
+    {
+      (*entry)->inWorld() = true;
+      m_activePopulation.push_back( *entry );
+      m_broadPhase->inserted( *entry );
+      this->insertIntoPool( entry->get() );
+    }
+
   m_activeAddEntries.clear();
 
+  std::sort( m_activePopulation.begin() + middle, m_activePopulation.end(), slotOrder );
+  std::inplace_merge( m_activePopulation.begin(), m_activePopulation.begin() + middle, m_activePopulation.end(), slotOrder );
+
   // enforce proper behaviour at screen edges
-  m_edgeOfScreen.clear();
+  m_boundary.remap( *store );
 
-  std::vector<active::ptr>::iterator itr( m_activePopulation.begin() );
-  std::vector<active::ptr>::iterator end( m_activePopulation.end() );
-  
-  for(; itr!=end; ++itr )
+  // everything is where it will be for the rest of the tick
+  store->advance();
+
+  return;
+}
+
+/** update the part of [First,Last) which falls in a pool whose first
+    member is Begin in the combined range, returns the start of the
+    next pool */
+template< typename T > static const size_t updateSlice( pool<T>& Pool, const physics::tick& Tick,
+						      const size_t Begin, const size_t First, const size_t Last )
+{
+  const size_t end( Begin + Pool.size() );
+  const size_t first( std::max( First,Begin ) );
+  const size_t last( std::min( Last,end ) );
+
+  if( first < last )
+    {
+      Pool.update( Tick, first - Begin, last - Begin );
+    }
+
+  return end;
+}
+
+void elementManager::updatePools( const physics::tick& Tick, const size_t First, const size_t Last )
+{
+  size_t begin(0);
+
+  begin = updateSlice( m_shells, Tick, begin, First, Last );
+  begin = updateSlice( m_rocks, Tick, begin, First, Last );
+  begin = updateSlice( m_ships, Tick, begin, First, Last );
+  begin = updateSlice( m_turrets, Tick, begin, First, Last );
+
+  return;
+}
+
+void elementManager::insertIntoPool( active* Arg )
+{
+  switch( Arg->tag() )
     {
-      m_boundary.remap( *itr, m_edgeOfScreen );
+    case entityStore::kRock:
+      m_rocks.insert( static_cast<rock*>(Arg) );
+      break;
+
+    case entityStore::kShell:
+      m_shells.insert( static_cast<shell*>(Arg) );
+      break;
+
+    case entityStore::kShip:
+      m_ships.insert( static_cast<ship*>(Arg) );
+      break;
+
+    case entityStore::kTurret:
+      m_turrets.insert( static_cast<turret*>(Arg) );
+      break;
+
+    default:
+      m_otherActives.push_back( Arg );
+      break;
+    }
+
+  return;
+}
+
+void elementManager::eraseFromPool( active* Arg )
+{
+  switch( Arg->tag() )
+    {
+    case entityStore::kRock:
+      m_rocks.erase( Arg );
+      break;
+
+    case entityStore::kShell:
+      m_shells.erase( Arg );
+      break;
+
+    case entityStore::kShip:
+      m_ships.erase( Arg );
+      break;
+
+    case entityStore::kTurret:
+      m_turrets.erase( Arg );
+      break;
+
+    default:
+      m_otherActives.erase( remove( m_otherActives.begin(),m_otherActives.end(),Arg ), m_otherActives.end() );
+      break;
     }
 
   return;
@@ -316,6 +697,15 @@ void elementManager::draw() const
   for_each( m_activePopulation.begin(),m_activePopulation.end(),mem_fun_ptr<active,void>( &active::draw ) );
 
   // draw elements which overlap screen edges
+  m_edgeOfScreen.clear();
+
+  std::vector<active::ptr>::const_iterator element( m_activePopulation.begin() );
+
+  for(; element!=m_activePopulation.end(); ++element )
+    {
+      m_boundary.copies( *element, m_edgeOfScreen );
+    }
+
   std::vector< std::pair<active::ptr,vec2d> >::const_iterator itr( m_edgeOfScreen.begin() );
   std::vector< std::pair<active::ptr,vec2d> >::const_iterator end( m_edgeOfScreen.end() );
 
@@ -327,92 +717,184 @@ void elementManager::draw() const
   return;
 }
 
+void elementManager::seed( const uint64_t Seed )
+{
+  Lock m(m_mutex);
+
+  m_seed = Seed;
+
+  for( size_t i(0); i<kStreamCount; ++i )
+    {
+      m_random[i].seed( Seed,i );
+    }
+
+  return;
+}
+
+void elementManager::broadPhase( const broadphase::mode_t Mode )
+{
+  Lock m(m_mutex);
+
+  delete m_broadPhase;
+  m_broadPhase = broadphase::generate( Mode );
+
+  // introduce the new broad phase to the existing population
+  std::vector<active::ptr>::iterator itr( m_activePopulation.begin() );
+  std::vector<active::ptr>::iterator end( m_activePopulation.end() );
+
+  for(; itr!=end; ++itr )
+    {
+      m_broadPhase->inserted( *itr );
+    }
+
+  return;
+}
+
 void elementManager::collide()
 {
   Lock m(m_mutex);
 
-  // collide active population with self
-  std::vector<active::ptr>::iterator itr1( m_activePopulation.begin() );
-  std::vector<active::ptr>::iterator itr2( m_activePopulation.begin() );
+  // collide active population with self, only pairs whose bounding
+  // circles overlap are passed to the narrow phase. Pairs which meet
+  // across the edge of the world carry the offset to the image of B
+  // nearest A, so no copies of the edge population are needed.
+  m_broadPhase->findPairs( m_activePopulation, m_boundary, m_candidates );
 
-  physics::collision Collision;	
+  // the narrow phase only reads the population, so the candidates
+  // are shared between the worker threads, each chunk writing the
+  // collisions it finds to its own list
+  const size_t chunks( (m_candidates.size() + kCollideGrain - 1) / kCollideGrain );
 
-  for(; itr1 != m_activePopulation.end(); ++itr1)
+  if( m_chunks.size() < chunks )
     {
-      for(itr2 = (itr1 +1); itr2 != m_activePopulation.end(); ++itr2)
-	{
-	  Collision = ::collide( itr1->get(), itr2->get() );
+      m_chunks.resize( chunks );
+    }
 
-	  if( Collision.result() && (m_boundary.contains( Collision.location() )) )
-	    {
-	      resolveCollision( *itr1,*itr2,Collision.location() );
-	    }
-	}
+  parallel::workers::create()->forEach( m_candidates.size(), kCollideGrain,
+					boost::bind( &elementManager::narrowPhase, this, _1, _2 ) );
+
+  // gather them into one batch in the order of the candidates, as
+  // if they had been found one after another
+  m_events.clear();
+
+  for( size_t chunk(0); chunk<chunks; ++chunk )
+    {
+      m_events.insert( m_events.end(), m_chunks[chunk].contacts.begin(), m_chunks[chunk].contacts.end() );
+      m_chunks[chunk].contacts.clear();
     }
- 
-  // collide screen edge population with active population and with self
-   std::vector< std::pair<active::ptr,vec2d> >::iterator itrEdge1( m_edgeOfScreen.begin() );
-   std::vector< std::pair<active::ptr,vec2d> >::iterator itrEdge2( m_edgeOfScreen.begin() );
-   std::vector< std::pair<active::ptr,vec2d> >::iterator endEdge( m_edgeOfScreen.end() );
- 
-   vec2d originalPosition1;
-   vec2d originalPosition2;
- 
-   for(; itrEdge1!=endEdge; ++itrEdge1)
-     {
-       originalPosition1 = itrEdge1->first->position(); 
-       itrEdge1->first->position() = itrEdge1->second;
-       
-       for(itr1 = m_activePopulation.begin();
- 	  itr1 != m_activePopulation.end(); 
- 	  ++itr1 )
- 	{
- 	  Collision = ::collide( itr1->get(), itrEdge1->first.get() );
- 
- 	  if( Collision.result() && (m_boundary.contains( Collision.location() )) )
- 	    {
-	      resolveCollision( *itr1,itrEdge1->first,Collision.location() );
- 	    }
- 	}
- 
-       for(itrEdge2 = m_edgeOfScreen.begin();
- 	  itrEdge2 != m_edgeOfScreen.end(); 
- 	  ++itrEdge2 )
- 	{
 
-	  originalPosition2 = itrEdge2->first->position(); 
-	  itrEdge2->first->position() = itrEdge2->second;
-      
+  // a fast particle may have passed through several shapes, the one
+  // it reached first takes the hit
+  std::stable_sort( m_events.begin(), m_events.end(), earlierContact );
 
- 	  Collision = ::collide( itrEdge2->first.get(), itrEdge1->first.get() );
- 
- 	  if( Collision.result() && (m_boundary.contains( Collision.location() )) )
- 	    {
-	      resolveCollision( itrEdge2->first,itrEdge1->first,Collision.location() );
- 	    }
+  // the game rules come first, on this thread, then anyone else who
+  // is interested
+  for_each( m_events.begin(), m_events.end(), std::ptr_fun<const contact&,void>( &resolveCollision ) );
+
+  for( size_t i(0); i<m_listeners.size(); ++i )
+    {
+      m_listeners[i]->contacts( m_events );
+    }
+
+  return;
+}
+
+void elementManager::narrowPhase( const size_t First, const size_t Last )
+{
+  narrowChunk& chunk( m_chunks[First / kCollideGrain] );
+
+  chunk.pairs.clear();
+
+  collisionPair pair;
+
+  for( size_t i(First); i<Last; ++i )
+    {
+      const broadphase::pair& candidate( m_candidates[i] );
+
+      pair.first  = m_activePopulation[candidate.first].get();
+      pair.second = m_activePopulation[candidate.second].get();
+      pair.offset = candidate.offset;
+      pair.motion = m_boundary.imageVelocity( pair.second->position(), pair.offset,
+					      pair.second->position() - pair.second->previous() )
+	- (pair.first->position() - pair.first->previous());
+
+      // gone since the population was last updated
+      if( pair.first->destroyed() || pair.second->destroyed() )
+	continue;
+
+      chunk.pairs.push_back( pair );
+    }
+
+  chunk.results.resize( chunk.pairs.size() );
+
+  if( !chunk.pairs.empty() )
+    {
+      ::collide( &chunk.pairs[0], chunk.pairs.size(), &chunk.results[0] );
+    }
+
+  contact found;
+
+  for( size_t i(0); i<chunk.pairs.size(); ++i )
+    {
+      const physics::collision& Collision( chunk.results[i] );
+
+      if( !Collision.result() )
+	continue;
 
-	  itrEdge2->first->position() = originalPosition2; 
- 	}
+      // a collision across the edge may lie just outside the world
+      found.location = m_boundary.wrap( Collision.location() );
 
-       itrEdge1->first->position() = originalPosition1; 
-     }
+      if( !m_boundary.contains( found.location ) )
+	continue;
 
-   return;
+      active*     A( chunk.pairs[i].first );
+      active*     B( chunk.pairs[i].second );
+      const vec2d offset( chunk.pairs[i].offset );
+
+      found.first            = A;
+      found.second           = B;
+      found.firstId          = A->slot();
+      found.secondId         = B->slot();
+      found.firstTag         = A->tag();
+      found.secondTag        = B->tag();
+      found.relativeVelocity = m_boundary.imageVelocity( B->position(), offset, B->velocity() ) - A->velocity();
+      found.time             = Collision.time();
+
+      chunk.contacts.push_back( found );
+    }
+
+  return;
+}
+
+void elementManager::addListener( contactListener* Arg )
+{
+  Lock m(m_mutex);
+  m_listeners.push_back( Arg );
+
+  return;
+}
+
+void elementManager::removeListener( contactListener* Arg )
+{
+  Lock m(m_mutex);
+  m_listeners.erase( remove( m_listeners.begin(),m_listeners.end(),Arg ), m_listeners.end() );
+
+  return;
 }
 
 void insertStars( const size_t StarCount )
 {
   elementManager*    world( elementManager::create() );
   graphics::display* display( graphics::display::create() );
+  randomStream&      random( world->random( elementManager::kLayoutStream ) );
 
-  srand( static_cast<int>(time(NULL)) );
   vec2d position;
 
   // generate random star field
   for( size_t i(0);i<StarCount;++i )
     {
-      position.x(display->dimension().x()*(rand()/(static_cast<double>(RAND_MAX))) );
-      position.y(display->dimension().y()*(rand()/(static_cast<double>(RAND_MAX))) );
+      position.x( display->dimension().x() * random.uniform() );
+      position.y( display->dimension().y() * random.uniform() );
       passive::ptr s(new star(position));
       world->insert(s);
     }
@@ -428,12 +910,11 @@ void insertEvenlyDistributed( std::vector<active::ptr>& Container )
   elementManager*    world( elementManager::create() );
   graphics::display* display( graphics::display::create() );
 
-  srand( static_cast<int>(time(NULL)) );
   const vec2d center( display->dimension() * 0.5 );
 
   const float angularSeparation( (2.0 * M_PI) / static_cast<float>(Container.size()) );
   vec2d position( center * 0.6 );
-  position.rotate( (rand()/(static_cast<float>(RAND_MAX))) * (2.0 * M_PI) );
+  position.rotate( world->random( elementManager::kLayoutStream ).uniform() * (2.0 * M_PI) );
 
   // generate rocks and insert into world
   iterator itr( Container.begin() );
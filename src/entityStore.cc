@@ -0,0 +1,134 @@
+// EntityStore.cxx
+//
+// Structure of arrays storage for the state of every item.
+
+#include <cmath>
+
+#include "entityStore.h"
+#include "lock.h"
+
+entityStore* entityStore::m_ptrToSelf = NULL;
+
+entityStore::entityStore():
+  m_blocks(),
+  m_size(0),
+  m_tick(0),
+  m_free(),
+  m_mutex(PTHREAD_RECURSIVE_MUTEX_INITIALIZER_NP)
+{}
+
+entityStore::~entityStore()
+{
+  for( size_t b(0); b<m_blocks.size(); ++b )
+    {
+      delete m_blocks[b];
+    }
+
+  pthread_mutex_destroy(&m_mutex);
+}
+
+entityStore* entityStore::create()
+{
+  if( m_ptrToSelf == NULL )
+    {
+      m_ptrToSelf = new entityStore();
+    }
+
+  return m_ptrToSelf;
+}
+
+const size_t entityStore::allocate()
+{
+  Lock m(m_mutex);
+
+  if( !m_free.empty() )
+    {
+      const size_t slot( m_free.top() );
+      m_free.pop();
+
+      return slot;
+    }
+
+  if( (m_size >> kBlockBits) == m_blocks.size() )
+    {
+      m_blocks.push_back( new block() );
+    }
+
+  return m_size++;
+}
+
+void entityStore::release( const size_t Slot )
+{
+  Lock m(m_mutex);
+
+  this->blockOf(Slot).inWorld[ offset(Slot) ] = false;
+  m_free.push( Slot );
+
+  return;
+}
+
+void entityStore::integrate( const physics::tick& Tick )
+{
+  Lock m(m_mutex);
+  this->integrate( Tick, 0, m_blocks.size() );
+
+  return;
+}
+
+void entityStore::integrate( const physics::tick& Tick, const size_t First, const size_t Last )
+{
+  // every slot moves over the whole tick, those which joined the
+  // world during the last one included
+  const physics::time_t duration( Tick.length );
+
+  for( size_t b(First); b<Last; ++b )
+    {
+      block&       Block( *m_blocks[b] );
+      const size_t count( this->used(b) );
+
+      for( size_t i(0); i<count; ++i )
+	{
+	  if( !Block.inWorld[i] )
+	    continue;
+
+	  Block.previous[i] = Block.position[i];
+
+	  // turn, as item::rotate()
+	  if( Block.rotation[i] != 0.0 )
+	    {
+	      Block.angle[i] += Block.rotation[i] * duration;
+
+	      if( Block.angle[i] > 2.0*M_PI )
+		{
+		  Block.angle[i] -= 2.0*M_PI;
+		}
+
+	      const float c( std::cos( Block.angle[i] ) );
+	      const float s( std::sin( Block.angle[i] ) );
+
+	      Block.angleCos[i]    = c;
+	      Block.angleSin[i]    = s;
+	      Block.orientation[i].set( -s,c );
+	    }
+
+	  // move, as item::translate()
+	  Block.position[i].x() += Block.velocity[i].x() * duration;
+	  Block.position[i].y() += Block.velocity[i].y() * duration;
+
+	  // swept slots are bounded about where they end up, with room
+	  // to reach back to where they started
+	  if( Block.sweepRadius[i] > 0.0 )
+	    {
+	      const float dx( Block.velocity[i].x() * duration );
+	      const float dy( Block.velocity[i].y() * duration );
+	      const float reach( Block.sweepRadius[i] + std::sqrt( dx*dx + dy*dy ) );
+
+	      Block.radiusSqrd[i] = reach * reach;
+	    }
+
+	  Block.time[i] = Tick.now;
+	}
+    }
+
+  return;
+}
@@ -212,11 +212,21 @@ namespace game
     return;
   }
   
-  void gui::draw()
+  void gui::update()
   {
+    for( size_t i(0); i<m_content.size(); ++i )
+      {
+	m_content[i]->update();
+      }
+
     // remove destroyed elements
     m_content.erase( remove_if( m_content.begin(),m_content.end(),destroyed<message>() ),m_content.end() );
 
+    return;
+  }
+
+  void gui::draw()
+  {
     // draw remaining elements
     for_each( m_content.begin(),m_content.end(),callDraw<message>() );
 
@@ -274,6 +284,11 @@ namespace game
   {
     graphics::drawString( m_content, gui::create()->hugeFont(), m_position + (m_velocity * m_clock.milliseconds()) );
 
+    return;
+  }
+
+  void levelMessage::update()
+  {
     // remove message if it has exceeded its time to live or if we
     // have moved on to the next level
     if( (m_clock.seconds() > m_ttl) || (m_level != state::create()->level()) )
@@ -321,11 +336,18 @@ namespace game
   {
     graphics::drawString( m_msgString, gui::create()->hugeFont(), m_msgPosition );
     graphics::drawString( m_infString, gui::create()->normFont(), m_infPosition );
-      
+
+    return;
+  }
+
+  void gameOverMessage::update()
+  {
     if( m_control->state(0) )
       {
 	this->destroy();
       } 
+
+    return;
   }
 
   //<-- pause message class -->
@@ -353,11 +375,18 @@ namespace game
   void pauseMessage::draw()
   {
     graphics::drawString( m_msgString, gui::create()->hugeFont(), m_msgPosition );
-      
+
+    return;
+  }
+
+  void pauseMessage::update()
+  {
     if( state::create()->pause() )
       {
 	this->destroy();
       } 
+
+    return;
   }
 
 
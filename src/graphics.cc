@@ -16,7 +16,7 @@ namespace graphics
   display* display::m_ptrToSelf = NULL;
   
   display::display():
-    m_screen(),
+    m_screen(NULL),
     m_dimension(512,512)
     {} 
 
@@ -34,9 +34,15 @@ namespace graphics
     }
 
 
-  void display::initialise() throw( exception )
+  void display::initialise( const bool Window ) throw( exception )
     {
-      if( -1 == SDL_Init(SDL_INIT_EVERYTHING))
+#ifdef HEADLESS
+      const bool window( false );
+#else
+      const bool window( Window );
+#endif
+
+      if( -1 == SDL_Init( window ? SDL_INIT_EVERYTHING : 0 ) )
 	{
 	  std::stringstream err;
 	  err << "failed to initialise SDL with error: " << SDL_GetError();
@@ -50,7 +56,11 @@ namespace graphics
       }
 
       atexit(SDL_Quit);
-	
+
+      if( !window )
+	return;
+
+#ifndef HEADLESS
       SDL_GL_SetAttribute( SDL_GL_RED_SIZE, 8);
       SDL_GL_SetAttribute( SDL_GL_GREEN_SIZE, 8);
       SDL_GL_SetAttribute( SDL_GL_BLUE_SIZE, 8);
@@ -79,6 +89,7 @@ namespace graphics
       glClearColor(0.0, 0.0, 0.0, 0.0);
 	
       SDL_WM_SetCaption("Asteroids", "Asteroids");
+#endif
 	
       return;
     }
@@ -90,15 +101,20 @@ namespace graphics
 
   void display::update()
     {
+      if( !this->window() )
+	return;
+
+#ifndef HEADLESS
       SDL_GL_SwapBuffers();
       glClear(GL_COLOR_BUFFER_BIT);
+#endif
 	
       return;
     }
 
   void display::lock()
     {
-      if(SDL_MUSTLOCK(m_screen))
+      if( this->window() && SDL_MUSTLOCK(m_screen))
 	{
 	  SDL_LockSurface(m_screen);
 	}
@@ -108,7 +124,7 @@ namespace graphics
 
   void display::unlock()
     {
-      if(SDL_MUSTLOCK(m_screen))
+      if( this->window() && SDL_MUSTLOCK(m_screen))
 	{
 	  SDL_UnlockSurface(m_screen);
 	}
@@ -121,6 +137,19 @@ namespace graphics
   drawable::~drawable()
     {}
 
+#ifdef HEADLESS
+  // nothing is drawn, see the namespace description
+  void drawLine( const vec2d&, const vec2d&, const int ) {}
+  void drawCircle( const vec2d&, float, int ) {}
+  void drawTriangle( const vec2d&, const vec2d&, float, int ) {}
+  void drawPixel( const int, const int, const Uint8, const Uint8, const Uint8 ) {}
+  void drawPoint( const vec2d&, const float, const Uint8, const Uint8, const Uint8 ) {}
+  void draw( const physics::clip& ) {}
+  void draw( const physics::clip&, const vec2d& ) {}
+  void drawChar( const char, font&, const vec2d& ) {}
+  void drawString( const std::string&, font&, const vec2d& ) {}
+#else
+
   void drawLine( const vec2d& a, const vec2d& b, const int colour )
     {
       float R;
@@ -255,23 +284,23 @@ namespace graphics
       physics::clip::const_iterator itr( Arg.begin() );
       physics::clip::const_iterator end( Arg.end() );
 
-      vec2d center( Arg.center() );
-
-      glBegin(GL_TRIANGLE_FAN);
-      
-      glVertex2f( center.x(),center.y() );
+      // filled with the triangles the clip was cut into, which unlike
+      // a fan about the center also cover a concave clip exactly
+      glBegin(GL_TRIANGLES);
 
-      for(; itr!=end;++itr )
+      for( size_t t(0); t<Arg.triangles(); ++t )
 	{
-	  glVertex2f( itr->x(),itr->y() );
-	}
+	  const unsigned char* corner( Arg.triangle(t) );
 
-      glVertex2f( Arg.at(0).x(),Arg.at(0).y() );
+	  for( size_t k(0); k<3; ++k )
+	    {
+	      glVertex2f( Arg.x()[corner[k]],Arg.y()[corner[k]] );
+	    }
+	}
 
       glEnd();
 
       glColor3f(1.0,1.0,1.0);
-      itr = Arg.begin();
 
       glBegin(GL_LINE_LOOP);
       
@@ -293,25 +322,21 @@ namespace graphics
       physics::clip::const_iterator itr( Arg.begin() );
       physics::clip::const_iterator end( Arg.end() );
 
-      glBegin(GL_POLYGON);
-
-      vec2d center( Arg.center() + Location );
-
-      glBegin(GL_TRIANGLE_FAN);
-      
-      glVertex2f( center.x(),center.y() );
+      glBegin(GL_TRIANGLES);
 
-      for(; itr!=end;++itr )
+      for( size_t t(0); t<Arg.triangles(); ++t )
 	{
-	  glVertex2f( itr->x() + Location.x(),itr->y() + Location.y() );
-	}
+	  const unsigned char* corner( Arg.triangle(t) );
 
-      glVertex2f( Arg.at(0).x() + Location.x(),Arg.at(0).y() + Location.y() );
+	  for( size_t k(0); k<3; ++k )
+	    {
+	      glVertex2f( Arg.x()[corner[k]] + Location.x(),Arg.y()[corner[k]] + Location.y() );
+	    }
+	}
       
       glEnd();
 
       glColor3f(1.0,1.0,1.0);
-      itr = Arg.begin();
 
       glBegin(GL_LINE_LOOP);
       
@@ -357,4 +382,6 @@ namespace graphics
       
     }
 
+#endif // HEADLESS
+
 }
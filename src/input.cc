@@ -6,6 +6,9 @@
 // input. Centered around the SDL event
 // handler.
 
+#include <fstream>
+#include <sstream>
+
 #include "input.h"
 
 control::control()
@@ -127,3 +130,103 @@ bool inputState::quit()
 {
   return m_sdl_quit;
 }
+
+// <-- class inputSource -->
+inputSource::inputSource()
+{}
+
+inputSource::~inputSource()
+{}
+
+// <-- class inputScript -->
+inputScript::inputScript( const std::string& File ) throw( exception ):
+  inputSource(),
+  m_events(),
+  m_next(0),
+  m_ticks(0)
+{
+  std::ifstream file( File.c_str() );
+
+  if( file.fail() )
+    {
+      throw( exception( "failed to open input script " + File ) );
+    }
+
+  std::string line;
+  size_t      number(0);
+
+  while( std::getline( file,line ) )
+    {
+      ++number;
+
+      std::istringstream fields( line );
+      std::string        first;
+
+      if( !(fields >> first) || (first[0] == '#') )
+	continue;
+
+      std::string key;
+      std::string direction;
+      event       next;
+
+      fields.clear();
+      fields.str( line );
+
+      if( !(fields >> next.tick >> key >> direction) || ((direction != "down") && (direction != "up")) )
+	{
+	  std::stringstream err;
+	  err << File << ":" << number << " expected 'tick key down|up'";
+
+	  throw( exception( err.str() ) );
+	}
+
+      if( !m_events.empty() && (next.tick < m_events.back().tick) )
+	{
+	  std::stringstream err;
+	  err << File << ":" << number << " is out of tick order";
+
+	  throw( exception( err.str() ) );
+	}
+
+      next.key  = keyFromName( key );
+      next.down = (direction == "down");
+
+      m_events.push_back( next );
+    }
+}
+
+inputScript::~inputScript()
+{}
+
+void inputScript::poll( const physics::tick& )
+{
+  inputState* input( inputState::create() );
+
+  for(; (m_next < m_events.size()) && (m_events[m_next].tick <= m_ticks); ++m_next )
+    {
+      input->setKeyState( m_events[m_next].key,m_events[m_next].down );
+    }
+
+  ++m_ticks;
+
+  return;
+}
+
+const bool inputScript::finished() const
+{
+  return m_next == m_events.size();
+}
+
+const int keyFromName( const std::string& Name ) throw( exception )
+{
+  static const char* names[] = { "up", "down", "left", "right", "x", "space", "pause", "q" };
+  static const int   keys[]  = { SDLK_UP, SDLK_DOWN, SDLK_LEFT, SDLK_RIGHT, SDLK_x, SDLK_SPACE, SDLK_PAUSE, SDLK_q };
+
+  for( size_t i(0); i<sizeof(keys)/sizeof(keys[0]); ++i )
+    {
+      if( Name == names[i] )
+	return keys[i];
+    }
+
+  throw( exception( "unknown key '" + Name + "'" ) );
+}
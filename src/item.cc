@@ -11,66 +11,100 @@
 
 item::item( const vec2d& Position ):
   graphics::drawable(),
-  m_destroyed(false),
-  m_position(Position),
-  m_velocity(),
-  m_rotation(0.0),
-  m_orientation(0,-1.0),
-  m_angle(M_PI)
-{}
+  m_slot( entityStore::create()->allocate() ),
+  m_block( &entityStore::create()->blockOf(m_slot) ),
+  m_offset( entityStore::offset(m_slot) )
+{
+  this->initialise( Position,vec2d() );
+}
 
 item::item( const vec2d& Position, 
 	    const vec2d& Velocity ):
   graphics::drawable(),
-  m_destroyed(false),
-  m_position(Position),
-  m_velocity(Velocity),
-  m_rotation(0.0),
-  m_orientation(0,-1.0),
-  m_angle(M_PI)
-{}
+  m_slot( entityStore::create()->allocate() ),
+  m_block( &entityStore::create()->blockOf(m_slot) ),
+  m_offset( entityStore::offset(m_slot) )
+{
+  this->initialise( Position,Velocity );
+}
 
 item::item( const item& Arg ):
   graphics::drawable(),
-  m_destroyed(Arg.destroyed()),
-  m_position(Arg.position()),
-  m_velocity(Arg.velocity()),
-  m_rotation(Arg.rotation()),
-  m_orientation(Arg.orientation()),
-  m_angle(Arg.angle())
-{}
+  m_slot( entityStore::create()->allocate() ),
+  m_block( &entityStore::create()->blockOf(m_slot) ),
+  m_offset( entityStore::offset(m_slot) )
+{
+  this->initialise( Arg.position(),Arg.velocity() );
+
+  *this = Arg;
+
+  this->setTag( Arg.tag() );
+  this->setRadiusSqrd( Arg.storedRadiusSqrd() );
+  this->setSweepRadius( Arg.m_block->sweepRadius[Arg.m_offset] );
+}
 
 item::~item()
-{}
+{
+  entityStore::create()->release( m_slot );
+}
 
 const item& item::operator=( const item& Arg )
 {
-  this->m_destroyed   = Arg.destroyed();
-  this->m_position    = Arg.position();
-  this->m_velocity    = Arg.velocity();
-  this->m_rotation    = Arg.rotation();
-  this->m_orientation = Arg.orientation();
-  this->m_angle       = Arg.angle();
+  m_block->destroyed[m_offset]   = Arg.destroyed();
+  m_block->position[m_offset]    = Arg.position();
+  m_block->previous[m_offset]    = Arg.previous();
+  m_block->velocity[m_offset]    = Arg.velocity();
+  m_block->rotation[m_offset]    = Arg.rotation();
+  m_block->orientation[m_offset] = Arg.orientation();
+  m_block->angle[m_offset]       = Arg.angle();
+  m_block->angleCos[m_offset]    = Arg.angleCos();
+  m_block->angleSin[m_offset]    = Arg.angleSin();
+  m_block->time[m_offset]        = Arg.updateTime();
 
   return *this;
 }
 
+void item::initialise( const vec2d& Position, const vec2d& Velocity )
+{
+  m_block->destroyed[m_offset]   = false;
+  m_block->position[m_offset]    = Position;
+  m_block->previous[m_offset]    = Position;
+  m_block->velocity[m_offset]    = Velocity;
+  m_block->rotation[m_offset]    = 0.0;
+  m_block->orientation[m_offset] = vec2d(0,-1.0);
+  m_block->angle[m_offset]       = M_PI;
+  m_block->angleCos[m_offset]    = -1.0;
+  m_block->angleSin[m_offset]    = 0.0;
+  m_block->radiusSqrd[m_offset]  = 0.0;
+  m_block->sweepRadius[m_offset] = 0.0;
+  m_block->time[m_offset]        = physics::runTime::create()->now();
+  m_block->impulses[m_offset]    = 0;
+  m_block->tag[m_offset]         = entityStore::kPassive;
+  m_block->inWorld[m_offset]     = false;
+
+  return;
+}
+
 void item::rotate( const float Angle )
 {
-  m_orientation.rotate(Angle);
-  m_angle += Angle;
+  float angle( m_block->angle[m_offset] + Angle );
 
-  if( m_angle > 2.0*M_PI)
+  if( angle > 2.0*M_PI)
     {
-      m_angle -= 2.0*M_PI;
+      angle -= 2.0*M_PI;
     }
+
+  this->setAngle( angle );
+
+  // the orientation points along the angle, see initialise()
+  this->orientation().set( -this->angleSin(),this->angleCos() );
 	
   return;
 }
 
 void item::translate( const vec2d& Arg )
 {
-  m_position += Arg;
+  this->position() += Arg;
 
   return;
 }
@@ -78,12 +112,12 @@ void item::translate( const vec2d& Arg )
 
 void item::destroy()
 {
-  m_destroyed = true;
+  m_block->destroyed[m_offset] = true;
 
   return;
 }
 
 const bool item::destroyed() const
 {
-  return m_destroyed;
+  return m_block->destroyed[m_offset];
 }
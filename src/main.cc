@@ -13,6 +13,7 @@
 #include <ctime>
 #include <pthread.h>
 #include <unistd.h>
+#include <getopt.h>
 #include <arpa/inet.h>
 #include <sys/time.h>
 #include <strings.h>
@@ -56,6 +57,20 @@ struct network_update_t {
 
 typedef std::pair<struct in_addr, ship*> thread_data_t;
 
+// most simulation ticks run to catch up with the clock between two
+// frames. A frame slower than this drops the rest rather than leave
+// the next one further behind.
+static const size_t kMaxTicksPerFrame = 5;
+
+// long names for the options which have them
+static const struct option kLongOptions[] = {
+    { "turbo", no_argument,       NULL, 'T' },
+    { "ticks", required_argument, NULL, 'N' },
+    { "seed",  required_argument, NULL, 'R' },
+    { "help",  no_argument,       NULL, 'h' },
+    { NULL,    0,                 NULL, 0 }
+};
+
 
 // receive-handler thread.
 static void * io_thread(void * arg /* unused */) {
@@ -226,6 +241,15 @@ int main(int argc, char* argv[])
     int ch;
     bool server = false;
     bool client = false;
+#ifdef HEADLESS
+    bool headless = true;
+#else
+    bool headless = false;
+#endif
+    bool turbo = false;
+    size_t tickLimit = 0;
+    uint64_t seed = static_cast<uint64_t>(time(NULL));
+    std::string script;
     struct timeval now, last_send;
     elementManager::activeContainer actives;
 
@@ -239,7 +263,7 @@ int main(int argc, char* argv[])
         IPaddress ipself;
         int channel;
 
-    while ((ch = getopt(argc, argv, "sc:h?a:b:z")) != -1) {
+    while ((ch = getopt_long(argc, argv, "sc:h?a:b:p:BzHS:TN:R:", kLongOptions, NULL)) != -1) {
       switch (ch) {
       case 's':
 	server = true;
@@ -267,6 +291,32 @@ int main(int argc, char* argv[])
       case 'b':
         bullet_factor = atoi(optarg);
         break;
+      case 'p':
+        world->broadPhase( broadphase::mode(optarg) );
+        break;
+      case 'B':
+        broadphase::benchmark( std::cout );
+        exit(0);
+        break;
+      case 'H':
+        headless = true;
+        break;
+      case 'S':
+        headless = true;
+        script = optarg;
+        break;
+      case 'T':
+        headless = true;
+        turbo = true;
+        break;
+      case 'N':
+        headless = true;
+        turbo = true;
+        tickLimit = strtoul(optarg, NULL, 10);
+        break;
+      case 'R':
+        seed = strtoull(optarg, NULL, 10);
+        break;
       default:
 	printf ("unknown option '%c'\n", ch);
       case 'h':
@@ -274,16 +324,48 @@ int main(int argc, char* argv[])
 	printf("%s: [-s | -c hostname]\n", argv[0]);
       printf("  -s: be a server\n");
       printf("  -c: connect to a server, named 'hostname'\n");
+      printf("  -p: collision broad phase, 'brute', 'grid' (default), 'sweep', 'tree' or 'cache'\n");
+      printf("  -B: time each broad phase and exit\n");
+      printf("  -H: run without a window, the ship flown by the computer\n");
+      printf("  -S: run without a window, the keys pressed as the script 'file' says\n");
+      printf("  -T, --turbo: run without a window as fast as possible, time simulated\n");
+      printf("  -N, --ticks: as --turbo, stopping after 'n' ticks\n");
+      printf("  -R, --seed: start the game from seed 'n', the time by default\n");
       exit(1);
       break;
       }
     }
     
-        printf ("Running asteroids\n");
+        // a turbo run moves time on itself, a tick at a time, rather
+        // than wait for the system clock. Installed before anything
+        // starts timing.
+        physics::simulatedSource simulatedTime;
+
+        if( turbo ) {
+            physics::timeSource::install( &simulatedTime );
+        }
+
+        // the same seed and the same input give the same game
+        world->seed( seed );
+
+        printf ("Running asteroids, seed %llu\n", static_cast<unsigned long long>(seed));
         inputState* userInput( inputState::create() );
     
         printf("Initializing...");
-        Display->initialise();
+        Display->initialise( !headless );
+        rock::makeOutlines();
+
+        // with no window there is no keyboard, the keys are pressed by
+        // a script or the computer instead
+        boost::shared_ptr<inputSource> source;
+
+        if( headless ) {
+            if( script.empty() ) {
+                source.reset( new ai::pilot );
+            } else {
+                source.reset( new inputScript( script ) );
+            }
+        }
     
         clock->start();
         clock->reset();
@@ -316,26 +398,70 @@ int main(int argc, char* argv[])
         }
 
         printf("done\n");
-        while( !(userInput->quit()) ) {
+
+        // the world is stepped at a fixed rate, however many ticks the
+        // clock has moved on by since the last frame, and drawn once a
+        // frame. Time stops while the clock is stopped for a pause.
+        const physics::time_t tickLength( 1.0 / physics::tick::kRate );
+        physics::time_t       simulated( clock->now() );
+        const physics::nanoseconds_t tickNanoseconds(
+            static_cast<physics::nanoseconds_t>( std::ceil( tickLength * 1e9 ) ) );
+        const physics::nanoseconds_t wallStart( physics::monotonicSource::create()->now() );
+        size_t                       ticksRun(0);
+
+        while( !(userInput->quit()) && !(source.get() && source->finished())
+               && !(tickLimit && ticksRun >= tickLimit) ) {
             gettimeofday(&now, 0);
             WRITE_ASTEROIDS_MAIN_START(now);
             WRITE_ASTEROIDS_A(rock::rockCount());
             WRITE_ASTEROIDS_B(shell::shellCount());
-            game::checkState();
 
-            userInput->readInput();
+            if( !source.get() ) {
+                userInput->readInput();
+            }
 
-            ai->update();
+            if( turbo ) {
+                simulatedTime.advance( tickNanoseconds );
+            }
 
-            world->update();
-            gettimeofday(&now, 0);
-            WRITE_ASTEROIDS_MAIN_MIDDLE(now);
-            world->collide();
+            const physics::time_t target( clock->now() );
+            size_t ticks(0);
+
+            while( (simulated + tickLength <= target) && (ticks < kMaxTicksPerFrame) ) {
+                simulated += tickLength;
+                ++ticks;
+                ++ticksRun;
+
+                const physics::tick tick( simulated );
+
+                if( source.get() ) {
+                    source->poll( tick );
+                }
+
+                game::checkState();
+                gui->update();
+                ai->update( tick );
+                world->update( tick );
+                gettimeofday(&now, 0);
+                WRITE_ASTEROIDS_MAIN_MIDDLE(now);
+                world->collide();
+            }
 
-            world->draw();
-            gui->draw();
+            if( simulated + tickLength <= target ) {
+                simulated = target;
+            }
+
+            if( headless ) {
+                // nothing to draw, wait for the next tick instead
+                if( ticks == 0 && !turbo ) {
+                    usleep( 1000 );
+                }
+            } else {
+                world->draw();
+                gui->draw();
             
-            Display->update();
+                Display->update();
+            }
 
             // transmit at 10 Hz
             if (server || client) {
@@ -401,6 +527,18 @@ int main(int argc, char* argv[])
             WRITE_ASTEROIDS_MAIN_END(now);
             ppt_write_asteroids_frame();
         }
+
+        if( turbo ) {
+            const double wall( (physics::monotonicSource::create()->now() - wallStart) * 1e-9 );
+
+            physics::timeSource::install( NULL );
+
+            printf( "%zu ticks (%.1f s simulated) in %.3f s, %.0f ticks/s, level %zu\n",
+                    ticksRun, ticksRun * tickLength, wall,
+                    wall > 0.0 ? ticksRun / wall : 0.0,
+                    game::state::create()->level() );
+        }
+
         Display->kill();
     }
     catch( std::exception& exp ) {
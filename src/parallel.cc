@@ -0,0 +1,240 @@
+// Parallel.cxx
+//
+// Loops over the population shared between threads, with the side
+// effects of each chunk deferred to its command buffer.
+
+#include <unistd.h>
+#include <algorithm>
+
+#include "parallel.h"
+#include "lock.h"
+
+namespace parallel
+{
+  /** the buffer of the chunk the thread is running */
+  static __thread commandBuffer* s_buffer = NULL;
+
+  // <-- commandBuffer -->
+
+  commandBuffer::commandBuffer():
+    m_commands()
+  {}
+
+  commandBuffer::~commandBuffer()
+  {}
+
+  void commandBuffer::push( const command& Arg )
+  {
+    m_commands.push_back( Arg );
+
+    return;
+  }
+
+  void commandBuffer::replay()
+  {
+    // commands may add more, which run immediately as the calling
+    // thread has no buffer
+    for( size_t i(0); i<m_commands.size(); ++i )
+      {
+	m_commands[i]();
+      }
+
+    m_commands.clear();
+
+    return;
+  }
+
+  commandBuffer* buffer()
+  {
+    return s_buffer;
+  }
+
+  void defer( const command& Arg )
+  {
+    if( s_buffer != NULL )
+      {
+	s_buffer->push( Arg );
+      }
+    else
+      {
+	Arg();
+      }
+
+    return;
+  }
+
+  // <-- workers -->
+
+  workers* workers::m_ptrToSelf = NULL;
+
+  workers::workers():
+    m_threads(),
+    m_mutex(PTHREAD_MUTEX_INITIALIZER),
+    m_start(PTHREAD_COND_INITIALIZER),
+    m_done(PTHREAD_COND_INITIALIZER),
+    m_generation(0),
+    m_quit(false),
+    m_job(),
+    m_count(0),
+    m_grain(1),
+    m_chunks(0),
+    m_next(0),
+    m_finished(0),
+    m_buffers()
+  {
+    const long processors( sysconf( _SC_NPROCESSORS_ONLN ) );
+
+    for( long i(1); i<processors; ++i )
+      {
+	pthread_t thread;
+
+	if( pthread_create( &thread, NULL, &workers::main, this ) != 0 )
+	  break;
+
+	m_threads.push_back( thread );
+      }
+  }
+
+  workers::~workers()
+  {
+    {
+      Lock m(m_mutex);
+      m_quit = true;
+      pthread_cond_broadcast(&m_start);
+    }
+
+    for( size_t i(0); i<m_threads.size(); ++i )
+      {
+	pthread_join( m_threads[i], NULL );
+      }
+
+    pthread_cond_destroy(&m_start);
+    pthread_cond_destroy(&m_done);
+    pthread_mutex_destroy(&m_mutex);
+  }
+
+  workers* workers::create()
+  {
+    if( m_ptrToSelf == NULL )
+      {
+	m_ptrToSelf = new workers();
+      }
+
+    return m_ptrToSelf;
+  }
+
+  void* workers::main( void* Arg )
+  {
+    workers* self( static_cast<workers*>(Arg) );
+    size_t   seen(0);
+
+    for(;;)
+      {
+	{
+	  Lock m(self->m_mutex);
+
+	  while( (self->m_generation == seen) && !self->m_quit )
+	    {
+	      pthread_cond_wait( &self->m_start, &self->m_mutex );
+	    }
+
+	  if( self->m_quit )
+	    return NULL;
+
+	  seen = self->m_generation;
+	}
+
+	self->work();
+      }
+
+    return NULL;
+  }
+
+  void workers::work()
+  {
+    for(;;)
+      {
+	size_t chunk;
+
+	{
+	  Lock m(m_mutex);
+
+	  if( m_next == m_chunks )
+	    return;
+
+	  chunk = m_next++;
+	}
+
+	const size_t first( chunk * m_grain );
+	const size_t last( std::min( first + m_grain, m_count ) );
+
+	s_buffer = &m_buffers[chunk];
+	m_job( first, last );
+	s_buffer = NULL;
+
+	{
+	  Lock m(m_mutex);
+
+	  if( ++m_finished == m_chunks )
+	    {
+	      pthread_cond_signal(&m_done);
+	    }
+	}
+      }
+
+    return;
+  }
+
+  void workers::forEach( const size_t Count, const size_t Grain, const job& Job )
+  {
+    if( Count == 0 )
+      return;
+
+    // not worth waking anyone
+    if( (Count <= Grain) || m_threads.empty() )
+      {
+	Job( 0, Count );
+	return;
+      }
+
+    {
+      Lock m(m_mutex);
+
+      m_job      = Job;
+      m_count    = Count;
+      m_grain    = Grain;
+      m_chunks   = (Count + Grain - 1) / Grain;
+      m_next     = 0;
+      m_finished = 0;
+
+      if( m_buffers.size() < m_chunks )
+	{
+	  m_buffers.resize( m_chunks );
+	}
+
+      ++m_generation;
+      pthread_cond_broadcast(&m_start);
+    }
+
+    this->work();
+
+    {
+      Lock m(m_mutex);
+
+      while( m_finished < m_chunks )
+	{
+	  pthread_cond_wait( &m_done, &m_mutex );
+	}
+
+      m_job = job();
+    }
+
+    // apply the side effects in the order a single thread would have
+    for( size_t chunk(0); chunk<m_chunks; ++chunk )
+      {
+	m_buffers[chunk].replay();
+      }
+
+    return;
+  }
+}
@@ -1,14 +1,91 @@
+#include <limits>
+#include <time.h>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
 #include "physics.h"
+#include "points.h"
 
 namespace physics
 {
+  // <-- timeSource class -->
+  const timeSource* timeSource::m_current = NULL;
+
+  timeSource::~timeSource()
+    {}
+
+  const timeSource* timeSource::current()
+    {
+      if( m_current == NULL )
+	{
+	  m_current = monotonicSource::create();
+	}
+
+      return m_current;
+    }
+
+  void timeSource::install( const timeSource* Arg )
+    {
+      m_current = Arg;
+
+      return;
+    }
+
+  // <-- monotonicSource class -->
+  monotonicSource* monotonicSource::m_ptrToSelf = NULL;
+
+  monotonicSource::monotonicSource():
+    timeSource()
+    {}
+
+  monotonicSource* monotonicSource::create()
+    {
+      if( m_ptrToSelf == NULL )
+	{
+	  m_ptrToSelf = new monotonicSource();
+	}
+
+      return m_ptrToSelf;
+    }
+
+  const nanoseconds_t monotonicSource::now() const
+    {
+      struct timespec rtn;
+      clock_gettime( CLOCK_MONOTONIC,&rtn );
+
+      return (static_cast<nanoseconds_t>( rtn.tv_sec ) * 1000000000) + rtn.tv_nsec;
+    }
+
+  // <-- simulatedSource class -->
+  simulatedSource::simulatedSource():
+    timeSource(),
+    m_now(0)
+    {}
+
+  simulatedSource::~simulatedSource()
+    {}
+
+  const nanoseconds_t simulatedSource::now() const
+    {
+      return __atomic_load_n( &m_now,__ATOMIC_RELAXED );
+    }
+
+  void simulatedSource::advance( const nanoseconds_t Arg )
+    {
+      __atomic_store_n( &m_now,m_now + Arg,__ATOMIC_RELAXED );
+
+      return;
+    }
+
   // <-- clock class -->
   clock::clock( const clock& arg ): m_startTime( arg.m_startTime ),
     m_stopTime( arg.m_stopTime ),
     m_running( arg.m_running )
     {}
 
-  clock::clock(): m_startTime( SDL_GetTicks() ),
+  clock::clock(): m_startTime( timeSource::current()->now() ),
     m_stopTime(0),
     m_running( true )
     {}
@@ -27,7 +104,7 @@ namespace physics
 
   void clock::reset()
     {
-      m_startTime = SDL_GetTicks();
+      m_startTime = timeSource::current()->now();
       m_stopTime  = 0;
 
       return;
@@ -37,7 +114,7 @@ namespace physics
     {
       if( !m_running )
 	{
-	  m_startTime = SDL_GetTicks();
+	  m_startTime = timeSource::current()->now();
 	  m_running   = true;
 	}
 
@@ -48,7 +125,7 @@ namespace physics
     {
       if( m_running )
 	{
-	  m_stopTime  = this->milliseconds();
+	  m_stopTime  = this->nanoseconds();
 	  m_running   = false;
 	}
 
@@ -74,13 +151,13 @@ namespace physics
       return;
     }
 
-  const time_t clock::milliseconds() const
+  const nanoseconds_t clock::nanoseconds() const
     {
-      time_t rtn;
+      nanoseconds_t rtn;
 
       if( m_running )
 	{
-	  rtn = m_stopTime + (SDL_GetTicks() - m_startTime);
+	  rtn = m_stopTime + (timeSource::current()->now() - m_startTime);
 	}
 
       else
@@ -91,9 +168,14 @@ namespace physics
       return rtn;
     }
 
+  const time_t clock::milliseconds() const
+    {
+      return this->nanoseconds() * 1e-6;
+    }
+
   const time_t clock::seconds() const
     {
-      return static_cast<size_t>( this-> milliseconds() * 0.001 );
+      return static_cast<size_t>( this->nanoseconds() / 1000000000 );
     }
 
   const time_t clock::minutes() const
@@ -137,17 +219,42 @@ namespace physics
   // <-- collision -->
   collision::collision():
     m_result(false),
-    m_location()
+    m_location(),
+    m_normal(),
+    m_depth(0.0),
+    m_time(1.0)
     {}
 
   collision::collision( const vec2d& Location ):
     m_result(true),
-    m_location(Location)
+    m_location(Location),
+    m_normal(),
+    m_depth(0.0),
+    m_time(1.0)
+    {}
+
+  collision::collision( const vec2d& Location, const vec2d& Normal, const float Depth ):
+    m_result(true),
+    m_location(Location),
+    m_normal(Normal),
+    m_depth(Depth),
+    m_time(1.0)
+    {}
+
+  collision::collision( const vec2d& Location, const float Time ):
+    m_result(true),
+    m_location(Location),
+    m_normal(),
+    m_depth(0.0),
+    m_time(Time)
     {}
 
   collision::collision( const collision& Arg ):
     m_result(Arg.result()),
-    m_location(Arg.location())
+    m_location(Arg.location()),
+    m_normal(Arg.normal()),
+    m_depth(Arg.depth()),
+    m_time(Arg.time())
     {}
 
   // <-- ray -->
@@ -219,50 +326,122 @@ namespace physics
     }
 
   // <-- clip -->
+  clip::clip():
+    m_size(0),
+    m_radiusSqrd(0.0),
+    m_center(),
+    m_convex(true),
+    m_pieces(0),
+    m_triangles(0)
+    {}
+
   clip::clip( const vec2d& A, const vec2d& B ):
-    m_backup(),
-    m_vertex(),
-    m_center()
+    m_size(2),
+    m_radiusSqrd(0.0),
+    m_center(),
+    m_convex(true),
+    m_pieces(0),
+    m_triangles(0)
     {
-      m_backup.push_back(A);
-      m_backup.push_back(B);
-      
-      m_vertex.reserve( m_backup.size() );
+      m_backupX[0] = A.x();
+      m_backupY[0] = A.y();
+      m_backupX[1] = B.x();
+      m_backupY[1] = B.y();
 
       this->reset();
       this->findCenter();
       this->findRadiusSqrd();
+      this->findNormals();
+      this->findPieces();
     }
   
-  clip::clip( const container& Arg ):
-    m_backup(Arg),
-    m_vertex(Arg),
-    m_center()
+  clip::clip( const container& Arg ) throw( exception ):
+    m_size( Arg.size() ),
+    m_radiusSqrd(0.0),
+    m_center(),
+    m_convex(true),
+    m_pieces(0),
+    m_triangles(0)
     {
+      if( m_size > kCapacity )
+	{
+	  std::stringstream err;
+	  err << "clip of " << m_size << " vertices, at most " << kCapacity << " may be held";
+	  throw( exception( err.str() ) );
+	}
+
+      for( size_t i(0); i<m_size; ++i )
+	{
+	  m_x[i] = Arg[i].x();
+	  m_y[i] = Arg[i].y();
+	}
+
       this->findCenter();
       this->findRadiusSqrd();
+      this->findNormals();
+      this->findPieces();
     }
 
   clip::clip( const clip& Arg ):
-    m_backup( Arg.m_backup ),
-    m_vertex( Arg.m_vertex ),
+    m_size( Arg.size() ),
     m_radiusSqrd( Arg.radiusSqrd() ),
-    m_center( Arg.center() )
-    {}
+    m_center( Arg.center() ),
+    m_convex( Arg.convex() ),
+    m_pieces(0),
+    m_triangles(0)
+    {
+      std::copy( Arg.m_backupX, Arg.m_backupX + m_size, m_backupX );
+      std::copy( Arg.m_backupY, Arg.m_backupY + m_size, m_backupY );
+      std::copy( Arg.m_x, Arg.m_x + m_size, m_x );
+      std::copy( Arg.m_y, Arg.m_y + m_size, m_y );
+      std::copy( Arg.m_normalX, Arg.m_normalX + m_size, m_normalX );
+      std::copy( Arg.m_normalY, Arg.m_normalY + m_size, m_normalY );
+
+      this->copyPieces( Arg );
+    }
 
   clip::~clip()
     {}
   
   const clip& clip::operator=( const clip& Arg )
     {
-      this->m_backup     = Arg.m_backup;
-      this->m_vertex     = Arg.m_vertex;
+      this->m_size       = Arg.size();
       this->m_radiusSqrd = Arg.radiusSqrd();
       this->m_center     = Arg.center();
+      this->m_convex     = Arg.convex();
+
+      std::copy( Arg.m_backupX, Arg.m_backupX + m_size, m_backupX );
+      std::copy( Arg.m_backupY, Arg.m_backupY + m_size, m_backupY );
+      std::copy( Arg.m_x, Arg.m_x + m_size, m_x );
+      std::copy( Arg.m_y, Arg.m_y + m_size, m_y );
+      std::copy( Arg.m_normalX, Arg.m_normalX + m_size, m_normalX );
+      std::copy( Arg.m_normalY, Arg.m_normalY + m_size, m_normalY );
+
+      this->copyPieces( Arg );
 
       return *this;
     }
 
+  void clip::copyPieces( const clip& Arg )
+    {
+      m_pieces    = Arg.m_pieces;
+      m_triangles = Arg.m_triangles;
+
+      std::copy( Arg.m_pieceEnd, Arg.m_pieceEnd + m_pieces, m_pieceEnd );
+      std::copy( Arg.m_pieceX, Arg.m_pieceX + m_pieces, m_pieceX );
+      std::copy( Arg.m_pieceY, Arg.m_pieceY + m_pieces, m_pieceY );
+      std::copy( Arg.m_pieceRadius, Arg.m_pieceRadius + m_pieces, m_pieceRadius );
+
+      const size_t total( (m_pieces == 0) ? 0 : Arg.m_pieceEnd[m_pieces - 1] );
+
+      std::copy( Arg.m_corner, Arg.m_corner + total, m_corner );
+      std::copy( Arg.m_cornerNormalX, Arg.m_cornerNormalX + total, m_cornerNormalX );
+      std::copy( Arg.m_cornerNormalY, Arg.m_cornerNormalY + total, m_cornerNormalY );
+      std::copy( Arg.m_triangle, Arg.m_triangle + 3*m_triangles, m_triangle );
+
+      return;
+    }
+
   const ray clip::line( const size_t Arg ) const
     {
       size_t a(Arg);
@@ -279,33 +458,55 @@ namespace physics
 
   void clip::reset()
     {
-      m_vertex = m_backup;
+      std::copy( m_backupX, m_backupX + m_size, m_x );
+      std::copy( m_backupY, m_backupY + m_size, m_y );
       m_center = vec2d();
 
+      if( m_size != 0 )
+	{
+	  this->findNormals();
+	}
+
+      if( m_pieces != 0 )
+	{
+	  this->placePieces();
+	}
+
       return;
     }
 
+  // the original configuration is centered too, so that reset()
+  // gives back the clip as it was made
   void clip::findCenter()
     {
-      const vec2d center( std::accumulate( this->begin(), this->end(), vec2d(0,0) ) );
-      for_each( this->begin(),this->end(),std::bind2nd( subtractAssign<vec2d>(),center ) );
+      if( m_size == 0 )
+	return;
+
+      const vec2d sum( std::accumulate( this->begin(), this->end(), vec2d(0,0) ) );
+      const vec2d center( sum * (1.0 / m_size) );
+
+      for( size_t i(0); i<m_size; ++i )
+	{
+	  m_x[i] -= center.x();
+	  m_y[i] -= center.y();
+	}
+
+      std::copy( m_x, m_x + m_size, m_backupX );
+      std::copy( m_y, m_y + m_size, m_backupY );
  
       return;
     }
 
   void clip::findRadiusSqrd()
     {
-      iterator itr( this->begin() );
-      iterator end( this->end() );
-
+      float mag[kCapacity];
       float max(0);
-      float mag(0);
 
-      for(; itr!=end;++itr )
-	{
-	  mag = itr->magSqrd();
+      points::distanceSqrd( m_x, m_y, m_size, vec2d(), mag );
 
-	  if( mag > max ) max = mag; 
+      for( size_t i(0); i<m_size; ++i )
+	{
+	  if( mag[i] > max ) max = mag[i]; 
 	}
 
       m_radiusSqrd = max;
@@ -313,17 +514,356 @@ namespace physics
       return;
     }
 
-  
+
+  void clip::findNormals()
+    {
+      const size_t count( this->size() );
+
+      // normals point out of the clip whichever way round it is wound
+      float area(0.0);
+
+      for( size_t i(0); i<count; ++i )
+	{
+	  const size_t b( (i+1) % count );
+
+	  area += m_x[i]*m_y[b] - m_x[b]*m_y[i];
+	}
+
+      const float outwards( (area < 0.0) ? -1.0 : 1.0 );
+
+      float turn(0.0);
+      m_convex = true;
+
+      for( size_t i(0); i<count; ++i )
+	{
+	  const size_t b( (i+1) % count );
+	  const size_t c( (i+2) % count );
+
+	  const float dx( m_x[b] - m_x[i] );
+	  const float dy( m_y[b] - m_y[i] );
+
+	  // made unit length below, a side of no length has none
+	  m_normalX[i] =  outwards * dy;
+	  m_normalY[i] = -outwards * dx;
+
+	  // every corner must turn the same way
+	  const float cross( dx*(m_y[c] - m_y[b]) - dy*(m_x[c] - m_x[b]) );
+
+	  if( cross * turn < 0.0 )
+	    {
+	      m_convex = false;
+	    }
+	  else if( cross != 0.0 )
+	    {
+	      turn = cross;
+	    }
+	}
+
+      points::normalise( m_normalX, m_normalY, count );
+
+      return;
+    }
+
+  /** twice the signed area of the triangle abc, positive if it turns
+      left */
+  static const float turning( const float* X, const float* Y, const size_t A, const size_t B, const size_t C )
+    {
+      return (X[B] - X[A])*(Y[C] - Y[B]) - (Y[B] - Y[A])*(X[C] - X[B]);
+    }
+
+  /** true if no corner of the polygon whose vertices are listed turns
+      against the winding given */
+  static const bool convexPolygon( const float* X, const float* Y, const unsigned char* Vertex, const size_t Count, const float Winding )
+    {
+      for( size_t i(0); i<Count; ++i )
+	{
+	  if( turning( X, Y, Vertex[i], Vertex[(i+1) % Count], Vertex[(i+2) % Count] ) * Winding < 0.0 )
+	    return false;
+	}
+
+      return true;
+    }
+
+  // ear clipping: a corner which turns the same way as the outline,
+  // with no other vertex in the triangle it makes with its
+  // neighbours, is cut off as a triangle until three are left. The
+  // triangles are then merged (Hertel-Mehlhorn) across the sides they
+  // share wherever the result is still convex, which leaves at most
+  // four times the fewest convex pieces possible.
+  void clip::findPieces()
+    {
+      const size_t count( m_size );
+
+      m_pieces    = 0;
+      m_triangles = 0;
+
+      if( count == 0 )
+	return;
+
+      // a convex clip is its own piece, cut into a fan for drawing
+      if( m_convex || (count < 4) )
+	{
+	  for( size_t i(0); i<count; ++i )
+	    {
+	      m_corner[i] = i;
+	    }
+
+	  m_pieceEnd[0] = count;
+	  m_pieces      = 1;
+
+	  for( size_t i(2); i<count; ++i )
+	    {
+	      m_triangle[3*m_triangles]     = 0;
+	      m_triangle[3*m_triangles + 1] = i - 1;
+	      m_triangle[3*m_triangles + 2] = i;
+	      ++m_triangles;
+	    }
+
+	  this->placePieces();
+	  return;
+	}
+
+      float area(0.0);
+
+      for( size_t i(0); i<count; ++i )
+	{
+	  const size_t b( (i+1) % count );
+
+	  area += m_x[i]*m_y[b] - m_x[b]*m_y[i];
+	}
+
+      const float winding( (area < 0.0) ? -1.0 : 1.0 );
+
+      unsigned char left[kCapacity];
+      size_t        remaining( count );
+
+      for( size_t i(0); i<count; ++i )
+	{
+	  left[i] = i;
+	}
+
+      while( remaining > 3 )
+	{
+	  size_t ear( remaining );
+
+	  for( size_t i(0); (i<remaining) && (ear == remaining); ++i )
+	    {
+	      const size_t a( left[(i + remaining - 1) % remaining] );
+	      const size_t b( left[i] );
+	      const size_t c( left[(i+1) % remaining] );
+
+	      if( turning( m_x, m_y, a, b, c ) * winding <= 0.0 )
+		continue;
+
+	      bool empty(true);
+
+	      for( size_t j(0); (j<remaining) && empty; ++j )
+		{
+		  const size_t v( left[j] );
+
+		  if( (v == a) || (v == b) || (v == c) )
+		    continue;
+
+		  empty = !( (turning( m_x, m_y, a, b, v ) * winding >= 0.0) &&
+			     (turning( m_x, m_y, b, c, v ) * winding >= 0.0) &&
+			     (turning( m_x, m_y, c, a, v ) * winding >= 0.0) );
+		}
+
+	      if( empty )
+		{
+		  ear = i;
+		}
+	    }
+
+	  // an outline which crosses itself may have no ear, cut off
+	  // the first corner anyway so that the loop ends
+	  if( ear == remaining )
+	    {
+	      ear = 0;
+	    }
+
+	  m_triangle[3*m_triangles]     = left[(ear + remaining - 1) % remaining];
+	  m_triangle[3*m_triangles + 1] = left[ear];
+	  m_triangle[3*m_triangles + 2] = left[(ear+1) % remaining];
+	  ++m_triangles;
+
+	  std::copy( left + ear + 1, left + remaining, left + ear );
+	  --remaining;
+	}
+
+      std::copy( left, left + 3, m_triangle + 3*m_triangles );
+      ++m_triangles;
+
+      // merge the triangles
+      unsigned char piece[kCapacity][kCapacity];
+      size_t        pieceSize[kCapacity];
+      size_t        pieces( m_triangles );
+
+      for( size_t p(0); p<pieces; ++p )
+	{
+	  std::copy( m_triangle + 3*p, m_triangle + 3*p + 3, piece[p] );
+	  pieceSize[p] = 3;
+	}
+
+      bool merged(true);
+
+      while( merged )
+	{
+	  merged = false;
+
+	  for( size_t p(0); (p<pieces) && !merged; ++p )
+	    {
+	      for( size_t q(p+1); (q<pieces) && !merged; ++q )
+		{
+		  const size_t sizeP( pieceSize[p] );
+		  const size_t sizeQ( pieceSize[q] );
+
+		  for( size_t i(0); (i<sizeP) && !merged; ++i )
+		    {
+		      const unsigned char a( piece[p][i] );
+		      const unsigned char b( piece[p][(i+1) % sizeP] );
+
+		      // q runs the other way along the side they share
+		      size_t j(0);
+
+		      while( (j<sizeQ) && !((piece[q][j] == b) && (piece[q][(j+1) % sizeQ] == a)) )
+			{
+			  ++j;
+			}
+
+		      if( j == sizeQ )
+			continue;
+
+		      // p from b round to a, then q from after a up to b
+		      unsigned char joined[kCapacity];
+		      size_t        size(0);
+
+		      for( size_t k(0); k<sizeP; ++k )
+			{
+			  joined[size++] = piece[p][(i + 1 + k) % sizeP];
+			}
+
+		      for( size_t k(2); k<sizeQ; ++k )
+			{
+			  joined[size++] = piece[q][(j + k) % sizeQ];
+			}
+
+		      if( !convexPolygon( m_x, m_y, joined, size, winding ) )
+			continue;
+
+		      std::copy( joined, joined + size, piece[p] );
+		      pieceSize[p] = size;
+
+		      for( size_t r(q+1); r<pieces; ++r )
+			{
+			  std::copy( piece[r], piece[r] + pieceSize[r], piece[r-1] );
+			  pieceSize[r-1] = pieceSize[r];
+			}
+
+		      --pieces;
+		      merged = true;
+		    }
+		}
+	    }
+	}
+
+      size_t corners(0);
+
+      for( size_t p(0); p<pieces; ++p )
+	{
+	  std::copy( piece[p], piece[p] + pieceSize[p], m_corner + corners );
+	  corners += pieceSize[p];
+	  m_pieceEnd[p] = corners;
+	}
+
+      m_pieces = pieces;
+      this->placePieces();
+
+      return;
+    }
+
+  void clip::placePieces()
+    {
+      float area(0.0);
+
+      for( size_t i(0); i<m_size; ++i )
+	{
+	  const size_t b( (i+1) % m_size );
+
+	  area += m_x[i]*m_y[b] - m_x[b]*m_y[i];
+	}
+
+      const float outwards( (area < 0.0) ? -1.0 : 1.0 );
+
+      for( size_t p(0); p<m_pieces; ++p )
+	{
+	  const size_t begin( this->pieceBegin(p) );
+	  const size_t end( this->pieceEnd(p) );
+	  float        x(0.0);
+	  float        y(0.0);
+
+	  for( size_t k(begin); k<end; ++k )
+	    {
+	      const size_t a( m_corner[k] );
+	      const size_t b( m_corner[ (k+1 == end) ? begin : k+1 ] );
+
+	      // made unit length below, as the side normals
+	      m_cornerNormalX[k] =  outwards * (m_y[b] - m_y[a]);
+	      m_cornerNormalY[k] = -outwards * (m_x[b] - m_x[a]);
+
+	      x += m_x[a];
+	      y += m_y[a];
+	    }
+
+	  m_pieceX[p] = x / (end - begin);
+	  m_pieceY[p] = y / (end - begin);
+
+	  float max(0.0);
+
+	  for( size_t k(begin); k<end; ++k )
+	    {
+	      const float dx( m_x[ m_corner[k] ] - m_pieceX[p] );
+	      const float dy( m_y[ m_corner[k] ] - m_pieceY[p] );
+
+	      max = std::max( max, dx*dx + dy*dy );
+	    }
+
+	  m_pieceRadius[p] = std::sqrt( max );
+	}
+
+      if( m_pieces != 0 )
+	{
+	  points::normalise( m_cornerNormalX, m_cornerNormalY, m_pieceEnd[m_pieces - 1] );
+	}
+
+      return;
+    }
+
   void rotate( clip& Clip, const float Angle )
     {
-      for_each( Clip.begin(),Clip.end(),std::bind2nd( std::mem_fun_ref( &vec2d::rotate ), Angle) );
+      rotate( Clip, cos(Angle), sin(Angle) );
+
+      return;
+    }
+
+  void rotate( clip& Clip, const float Cos, const float Sin )
+    {
+      points::rotate( Clip.m_x, Clip.m_y, Clip.m_size, Cos, Sin );
+      points::rotate( Clip.m_normalX, Clip.m_normalY, Clip.m_size, Cos, Sin );
+
+      if( Clip.m_pieces != 0 )
+	{
+	  points::rotate( Clip.m_cornerNormalX, Clip.m_cornerNormalY, Clip.m_pieceEnd[Clip.m_pieces - 1], Cos, Sin );
+	  points::rotate( Clip.m_pieceX, Clip.m_pieceY, Clip.m_pieces, Cos, Sin );
+	}
 	
       return;
     }
  
   void translate( clip& Clip, const vec2d& Position )
     {
-      for_each( Clip.begin(),Clip.end(),std::bind2nd( addAssign<vec2d>(), Position ) );
+      points::translate( Clip.m_x, Clip.m_y, Clip.m_size, Position );
+      points::translate( Clip.m_pieceX, Clip.m_pieceY, Clip.m_pieces, Position );
       Clip.center() += Position;
 
       return;
@@ -337,44 +877,214 @@ namespace physics
       return;
     }
 
-  const collision collide( const clip& A, const clip& B )
+  void transform( const clip& Clip, const float Angle, const vec2d& Position, clip& Result )
+    {
+      transform( Clip, cos(Angle), sin(Angle), Position, Result );
+
+      return;
+    }
+
+  void transform( const clip& Clip, const float Cos, const float Sin, const vec2d& Position, clip& Result )
+    {
+      const size_t count( Clip.m_size );
+
+      std::copy( Clip.m_x, Clip.m_x + count, Result.m_x );
+      std::copy( Clip.m_y, Clip.m_y + count, Result.m_y );
+      std::copy( Clip.m_normalX, Clip.m_normalX + count, Result.m_normalX );
+      std::copy( Clip.m_normalY, Clip.m_normalY + count, Result.m_normalY );
+      Result.m_size       = count;
+      Result.m_radiusSqrd = Clip.m_radiusSqrd;
+      Result.m_center     = Clip.m_center;
+      Result.m_convex     = Clip.m_convex;
+      Result.copyPieces( Clip );
+
+      rotate( Result, Cos, Sin );
+      translate( Result, Position );
+
+      return;
+    }
+
+  /** a convex polygon as the separating axis test sees it: its
+      vertices in order and the outward unit normal of the side from
+      each to the next */
+  struct hull
+  {
+    const float* x;
+    const float* y;
+    const float* normalX;
+    const float* normalY;
+    size_t       size;
+  };
+
+  /** a whole convex clip */
+  static const hull wholeOf( const clip& Clip )
+    {
+      const hull rtn = { Clip.x(), Clip.y(), Clip.normalX(), Clip.normalY(), Clip.size() };
+
+      return rtn;
+    }
+
+  /** the corners of one piece of a clip gathered in order */
+  struct pieceBuffer
+  {
+    float x[clip::kCapacity];
+    float y[clip::kCapacity];
+    float normalX[clip::kCapacity];
+    float normalY[clip::kCapacity];
+  };
+
+  static const hull pieceOf( const clip& Clip, const size_t Piece, pieceBuffer& Buffer )
     {
-      collision rtn;
+      const size_t begin( Clip.pieceBegin(Piece) );
+      const size_t end( Clip.pieceEnd(Piece) );
 
-      for( size_t lineA(0); lineA < A.lineCount(); ++lineA )
+      for( size_t k(begin); k<end; ++k )
 	{
-	  for( size_t lineB(0); lineB < B.lineCount(); ++lineB )
-	    {
-	      rtn = collide( A.line(lineA), B.line(lineB) );
+	  const size_t v( Clip.corner(k) );
+	  const vec2d  n( Clip.cornerNormal(k) );
+
+	  Buffer.x[k - begin]       = Clip.x()[v];
+	  Buffer.y[k - begin]       = Clip.y()[v];
+	  Buffer.normalX[k - begin] = n.x();
+	  Buffer.normalY[k - begin] = n.y();
+	}
+
+      const hull rtn = { Buffer.x, Buffer.y, Buffer.normalX, Buffer.normalY, end - begin };
+
+      return rtn;
+    }
+
+  /** tests the side normals of First as axes, each side of a convex
+      clip marking the extent of the clip along its own normal. Returns
+      false as soon as Second lies wholly beyond one, otherwise narrows
+      Depth to the least distance Second reaches past any side, giving
+      that side's Normal and the Deepest vertex of Second. */
+  static const bool overlapOnAxes( const hull& First, const hull& Second, float& Depth, vec2d& Normal, vec2d& Deepest )
+    {
+      float projection[clip::kCapacity];
+
+      for( size_t i(0); i<First.size; ++i )
+	{
+	  const float x( First.normalX[i] );
+	  const float y( First.normalY[i] );
 
-	      if( rtn.result() )
+	  // a side of no length
+	  if( (x == 0.0) && (y == 0.0) )
+	    continue;
+
+	  points::dot( Second.x, Second.y, Second.size, vec2d( x,y ), projection );
+
+	  size_t deepest(0);
+	  float  least( projection[0] );
+
+	  for( size_t j(1); j<Second.size; ++j )
+	    {
+	      if( projection[j] < least )
 		{
-		  return rtn;
+		  least   = projection[j];
+		  deepest = j;
 		}
 	    }
+
+	  const float depth( First.x[i] * x + First.y[i] * y - least );
+
+	  if( depth < 0.0 )
+	    return false;
+
+	  if( depth < Depth )
+	    {
+	      Depth   = depth;
+	      Normal.set( x,y );
+	      Deepest.set( Second.x[deepest],Second.y[deepest] );
+	    }
 	}
-      
-      return collision();
+
+      return true;
     }
 
-  const collision collide( const vec2d& Point, const clip& Clip )
+  /** separating axis test of two convex polygons */
+  static const collision separatingAxis( const hull& A, const hull& B )
     {
+      const float none( std::numeric_limits<float>::max() );
+      float       depth( none );
+      vec2d       normal;
+      vec2d       deepest;
+
+      if( !overlapOnAxes( A,B,depth,normal,deepest ) )
+	return collision();
+
+      const float depthA( depth );
+
+      if( !overlapOnAxes( B,A,depth,normal,deepest ) )
+	return collision();
+
+      // every side was of no length
+      if( depth == none )
+	return collision();
+
+      // a side of A separates them least: B moves out along its
+      // normal. Otherwise a side of B does and B moves the other way.
+      if( depth == depthA )
+	{
+	  return collision( deepest,normal,depth );
+	}
 
-      vec2d endPoint( Point );
-      endPoint.x() += 500.0;
+      return collision( deepest,-normal,depth );
+    }
+
+  const collision collide( const clip& A, const clip& B )
+    {
+      if( A.convex() && B.convex() )
+	{
+	  return separatingAxis( wholeOf(A),wholeOf(B) );
+	}
 
-      const ray testRay( Point,endPoint );
-      size_t count(0);
+      collision   rtn;
+      pieceBuffer bufferA;
+      pieceBuffer bufferB;
 
-      for( size_t i(0);i<Clip.lineCount();++i )
+      for( size_t p(0); p<A.pieces(); ++p )
 	{
-	  if( collide( testRay, Clip.line(i) ).result() )
+	  const vec2d centerA( A.pieceCenter(p) );
+	  const float radiusA( A.pieceRadius(p) );
+	  bool        gathered(false);
+	  hull        pieceA;
+
+	  for( size_t q(0); q<B.pieces(); ++q )
 	    {
-	      ++count;
+	      const float reach( radiusA + B.pieceRadius(q) );
+
+	      if( (centerA - B.pieceCenter(q)).magSqrd() > reach*reach )
+		continue;
+
+	      // only gathered once a piece of B comes near it
+	      if( !gathered )
+		{
+		  pieceA   = pieceOf( A,p,bufferA );
+		  gathered = true;
+		}
+
+	      const collision found( separatingAxis( pieceA,pieceOf( B,q,bufferB ) ) );
+
+	      if( found.result() && (!rtn.result() || (found.depth() > rtn.depth())) )
+		{
+		  rtn = found;
+		}
 	    }
 	}
       
-      if( (count % 2) == 0 )
+      return rtn;
+    }
+
+  const collision collide( const vec2d& Point, const clip& Clip )
+    {
+      const float   x( Point.x() );
+      const float   y( Point.y() );
+      unsigned char hit;
+
+      collide( &x, &y, 1, Clip, &hit );
+
+      if( !hit )
 	{
 	  return collision();
 	}
@@ -382,6 +1092,164 @@ namespace physics
       return collision(Point);      
     }
 
+  // a ray from each point along +x crosses the sides of the clip an
+  // odd number of times if the point is inside. A side is crossed if
+  // it spans the point's y, counting its lower end but not its upper
+  // so that a ray through a corner is counted once, and meets the ray
+  // right of the point.
+  void collide( const float* X, const float* Y, const size_t Count, const clip& Clip, unsigned char* Hits )
+    {
+      std::fill( Hits, Hits + Count, 0 );
+
+      const size_t sides( Clip.size() );
+
+      if( sides < 2 )
+	return;
+
+      for( size_t i(0); i<sides; ++i )
+	{
+	  const vec2d a( Clip.at(i) );
+	  const vec2d b( Clip.at( (i+1) % sides ) );
+
+	  // level sides are never crossed
+	  if( a.y() == b.y() )
+	    continue;
+
+	  const float slope( (b.x() - a.x()) / (b.y() - a.y()) );
+	  size_t      j(0);
+
+#ifdef __SSE2__
+	  const __m128 ax( _mm_set1_ps( a.x() ) );
+	  const __m128 ay( _mm_set1_ps( a.y() ) );
+	  const __m128 by( _mm_set1_ps( b.y() ) );
+	  const __m128 m( _mm_set1_ps( slope ) );
+
+	  for(; j+4<=Count; j+=4 )
+	    {
+	      const __m128 px( _mm_loadu_ps( X + j ) );
+	      const __m128 py( _mm_loadu_ps( Y + j ) );
+
+	      const __m128 spans( _mm_xor_ps( _mm_cmpgt_ps( ay,py ),_mm_cmpgt_ps( by,py ) ) );
+	      const __m128 cross( _mm_add_ps( ax,_mm_mul_ps( _mm_sub_ps( py,ay ),m ) ) );
+	      const int    mask( _mm_movemask_ps( _mm_and_ps( spans,_mm_cmplt_ps( px,cross ) ) ) );
+
+	      Hits[j]   ^= mask & 1;
+	      Hits[j+1] ^= (mask >> 1) & 1;
+	      Hits[j+2] ^= (mask >> 2) & 1;
+	      Hits[j+3] ^= (mask >> 3) & 1;
+	    }
+#endif
+
+	  for(; j<Count; ++j )
+	    {
+	      if( ((a.y() > Y[j]) != (b.y() > Y[j])) &&
+		  (X[j] < a.x() + (Y[j] - a.y()) * slope) )
+		{
+		  Hits[j] ^= 1;
+		}
+	    }
+	}
+
+      return;
+    }
+
+  void sweep( const float* X0, const float* Y0, const float* X1, const float* Y1, const size_t Count,
+	      const clip& Clip, unsigned char* Hits, float* Times )
+    {
+      // a point which starts inside has hit at once, one which starts
+      // outside must cross a side to get in
+      collide( X0, Y0, Count, Clip, Hits );
+
+      const size_t sides( Clip.size() );
+
+      if( sides < 2 )
+	{
+	  std::fill( Times, Times + Count, 1.0f );
+	  return;
+	}
+
+      // the earliest crossing so far, beyond the end of the move
+      // until one is found
+      std::fill( Times, Times + Count, 2.0f );
+
+      for( size_t i(0); i<sides; ++i )
+	{
+	  const vec2d a( Clip.at(i) );
+	  const vec2d b( Clip.at( (i+1) % sides ) );
+	  const float  ex( b.x() - a.x() );
+	  const float  ey( b.y() - a.y() );
+	  size_t       j(0);
+
+	  // the path p0 + t(p1 - p0) meets the side a + u(b - a) where
+	  // t and u both lie in [0,1]. A path parallel to the side
+	  // divides by zero, and fails both tests.
+#ifdef __SSE2__
+	  const __m128 ax( _mm_set1_ps( a.x() ) );
+	  const __m128 ay( _mm_set1_ps( a.y() ) );
+	  const __m128 sx( _mm_set1_ps( ex ) );
+	  const __m128 sy( _mm_set1_ps( ey ) );
+	  const __m128 zero( _mm_setzero_ps() );
+	  const __m128 one( _mm_set1_ps( 1.0f ) );
+	  const __m128 never( _mm_set1_ps( 2.0f ) );
+
+	  for(; j+4<=Count; j+=4 )
+	    {
+	      const __m128 px( _mm_loadu_ps( X0 + j ) );
+	      const __m128 py( _mm_loadu_ps( Y0 + j ) );
+	      const __m128 dx( _mm_sub_ps( _mm_loadu_ps( X1 + j ),px ) );
+	      const __m128 dy( _mm_sub_ps( _mm_loadu_ps( Y1 + j ),py ) );
+	      const __m128 wx( _mm_sub_ps( ax,px ) );
+	      const __m128 wy( _mm_sub_ps( ay,py ) );
+
+	      const __m128 denom( _mm_sub_ps( _mm_mul_ps( dx,sy ),_mm_mul_ps( dy,sx ) ) );
+	      const __m128 t( _mm_div_ps( _mm_sub_ps( _mm_mul_ps( wx,sy ),_mm_mul_ps( wy,sx ) ),denom ) );
+	      const __m128 u( _mm_div_ps( _mm_sub_ps( _mm_mul_ps( wx,dy ),_mm_mul_ps( wy,dx ) ),denom ) );
+
+	      const __m128 meets( _mm_and_ps( _mm_and_ps( _mm_cmpge_ps( t,zero ),_mm_cmple_ps( t,one ) ),
+					      _mm_and_ps( _mm_cmpge_ps( u,zero ),_mm_cmple_ps( u,one ) ) ) );
+	      const __m128 when( _mm_or_ps( _mm_and_ps( meets,t ),_mm_andnot_ps( meets,never ) ) );
+
+	      _mm_storeu_ps( Times + j, _mm_min_ps( _mm_loadu_ps( Times + j ),when ) );
+	    }
+#endif
+
+	  for(; j<Count; ++j )
+	    {
+	      const float dx( X1[j] - X0[j] );
+	      const float dy( Y1[j] - Y0[j] );
+	      const float wx( a.x() - X0[j] );
+	      const float wy( a.y() - Y0[j] );
+
+	      const float denom( (dx * ey) - (dy * ex) );
+	      const float t( ((wx * ey) - (wy * ex)) / denom );
+	      const float u( ((wx * dy) - (wy * dx)) / denom );
+
+	      if( (t >= 0.0f) && (t <= 1.0f) && (u >= 0.0f) && (u <= 1.0f) && (t < Times[j]) )
+		{
+		  Times[j] = t;
+		}
+	    }
+	}
+
+      for( size_t j(0); j<Count; ++j )
+	{
+	  if( Hits[j] )
+	    {
+	      Times[j] = 0.0f;
+	    }
+	  else if( Times[j] <= 1.0f )
+	    {
+	      Hits[j] = 1;
+	    }
+	  else
+	    {
+	      Times[j] = 1.0f;
+	    }
+	}
+
+      return;
+    }
+
   const clip triangleClip( const float Size )
     {
       std::vector<vec2d> vertex;
@@ -411,7 +1279,7 @@ namespace physics
       return clip( vertex );
     }
  
-  const clip rockClip( const float Radius, const size_t nSides )
+  const clip rockClip( const float Radius, const size_t nSides, randomStream& Random )
     {
       const float angle( (2.0 * M_PI) / nSides );
       vec2d point;
@@ -420,8 +1288,12 @@ namespace physics
 
       for( size_t i(1);i<nSides;++i )
 	{
-	  point.polar( angle * ((std::rand())/(double)RAND_MAX)  + ( angle * i), 
-		       ((std::rand())/(double)RAND_MAX) * 0.3 *Radius + 0.7 * Radius );
+	  // drawn in turn, the order arguments are found in is not fixed
+	  const double bearing( Random.uniform() );
+	  const double reach( Random.uniform() );
+
+	  point.polar( angle * bearing + ( angle * i), 
+		       reach * 0.3 *Radius + 0.7 * Radius );
 	  vertex.push_back( point );
 	}
     
@@ -0,0 +1,160 @@
+// Points.cxx
+//
+// Operations on arrays of points, several at a time.
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+#include "points.h"
+
+namespace points
+{
+  void translate( float* X, float* Y, const size_t Count, const vec2d& Offset )
+  {
+    size_t i(0);
+
+#ifdef __SSE2__
+    const __m128 ox( _mm_set1_ps( Offset.x() ) );
+    const __m128 oy( _mm_set1_ps( Offset.y() ) );
+
+    for(; i+4<=Count; i+=4 )
+      {
+	_mm_storeu_ps( X + i, _mm_add_ps( _mm_loadu_ps( X + i ),ox ) );
+	_mm_storeu_ps( Y + i, _mm_add_ps( _mm_loadu_ps( Y + i ),oy ) );
+      }
+#endif
+
+    for(; i<Count; ++i )
+      {
+	X[i] += Offset.x();
+	Y[i] += Offset.y();
+      }
+
+    return;
+  }
+
+  void rotate( float* X, float* Y, const size_t Count, const float Cos, const float Sin )
+  {
+    size_t i(0);
+
+#ifdef __SSE2__
+    const __m128 c( _mm_set1_ps( Cos ) );
+    const __m128 s( _mm_set1_ps( Sin ) );
+
+    for(; i+4<=Count; i+=4 )
+      {
+	const __m128 x( _mm_loadu_ps( X + i ) );
+	const __m128 y( _mm_loadu_ps( Y + i ) );
+
+	_mm_storeu_ps( X + i, _mm_sub_ps( _mm_mul_ps( x,c ),_mm_mul_ps( y,s ) ) );
+	_mm_storeu_ps( Y + i, _mm_add_ps( _mm_mul_ps( x,s ),_mm_mul_ps( y,c ) ) );
+      }
+#endif
+
+    for(; i<Count; ++i )
+      {
+	const float x( X[i] );
+
+	X[i] = x*Cos - Y[i]*Sin;
+	Y[i] = x*Sin + Y[i]*Cos;
+      }
+
+    return;
+  }
+
+  void rotate( float* X, float* Y, const size_t Count, const float Angle )
+  {
+    rotate( X, Y, Count, std::cos(Angle), std::sin(Angle) );
+
+    return;
+  }
+
+  void dot( const float* X, const float* Y, const size_t Count, const vec2d& Axis, float* Result )
+  {
+    size_t i(0);
+
+#ifdef __SSE2__
+    const __m128 ax( _mm_set1_ps( Axis.x() ) );
+    const __m128 ay( _mm_set1_ps( Axis.y() ) );
+
+    for(; i+4<=Count; i+=4 )
+      {
+	_mm_storeu_ps( Result + i, _mm_add_ps( _mm_mul_ps( _mm_loadu_ps( X + i ),ax ),
+					       _mm_mul_ps( _mm_loadu_ps( Y + i ),ay ) ) );
+      }
+#endif
+
+    for(; i<Count; ++i )
+      {
+	Result[i] = X[i]*Axis.x() + Y[i]*Axis.y();
+      }
+
+    return;
+  }
+
+  void distanceSqrd( const float* X, const float* Y, const size_t Count, const vec2d& Point, float* Result )
+  {
+    size_t i(0);
+
+#ifdef __SSE2__
+    const __m128 px( _mm_set1_ps( Point.x() ) );
+    const __m128 py( _mm_set1_ps( Point.y() ) );
+
+    for(; i+4<=Count; i+=4 )
+      {
+	const __m128 dx( _mm_sub_ps( _mm_loadu_ps( X + i ),px ) );
+	const __m128 dy( _mm_sub_ps( _mm_loadu_ps( Y + i ),py ) );
+
+	_mm_storeu_ps( Result + i, _mm_add_ps( _mm_mul_ps( dx,dx ),_mm_mul_ps( dy,dy ) ) );
+      }
+#endif
+
+    for(; i<Count; ++i )
+      {
+	const float dx( X[i] - Point.x() );
+	const float dy( Y[i] - Point.y() );
+
+	Result[i] = dx*dx + dy*dy;
+      }
+
+    return;
+  }
+
+  void normalise( float* X, float* Y, const size_t Count )
+  {
+    size_t i(0);
+
+    // a full square root and divide rather than the reciprocal
+    // estimates, which are not accurate enough for a unit normal
+#ifdef __SSE2__
+    const __m128 zero( _mm_setzero_ps() );
+    const __m128 one( _mm_set1_ps( 1.0f ) );
+
+    for(; i+4<=Count; i+=4 )
+      {
+	const __m128 x( _mm_loadu_ps( X + i ) );
+	const __m128 y( _mm_loadu_ps( Y + i ) );
+	const __m128 length( _mm_sqrt_ps( _mm_add_ps( _mm_mul_ps( x,x ),_mm_mul_ps( y,y ) ) ) );
+	const __m128 none( _mm_cmpeq_ps( length,zero ) );
+	const __m128 divisor( _mm_or_ps( _mm_andnot_ps( none,length ),_mm_and_ps( none,one ) ) );
+
+	_mm_storeu_ps( X + i, _mm_div_ps( x,divisor ) );
+	_mm_storeu_ps( Y + i, _mm_div_ps( y,divisor ) );
+      }
+#endif
+
+    for(; i<Count; ++i )
+      {
+	const float length( std::sqrt( X[i]*X[i] + Y[i]*Y[i] ) );
+
+	if( length != 0.0f )
+	  {
+	    X[i] /= length;
+	    Y[i] /= length;
+	  }
+      }
+
+    return;
+  }
+}
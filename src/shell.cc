@@ -34,9 +34,10 @@ static pthread_mutex_t s_shellcnt_lock = PTHREAD_MUTEX_INITIALIZER;
 shell::shell(const vec2d& Position, const vec2d& Velocity ):
   particle( Position,Velocity,2.0 ),
      m_range( 450.0 ),
-     m_travel(0.0),
-     m_updateTime(physics::runTime::create()->now())
+     m_travel(0.0)
 {
+  this->setTag( entityStore::kShell );
+
   Lock m(s_shellcnt_lock);
   s_shell_cnt++;
 }
@@ -44,8 +45,7 @@ shell::shell(const vec2d& Position, const vec2d& Velocity ):
 shell::shell( const shell& Arg ):
   particle( Arg ),
      m_range( Arg.m_range ),
-     m_travel( Arg.m_travel ),
-     m_updateTime( Arg.m_updateTime )
+     m_travel( Arg.m_travel )
 {
   Lock m(s_shellcnt_lock);
   s_shell_cnt++;
@@ -68,30 +68,10 @@ const shell& shell::operator=( const shell& Arg )
   
   this->m_range      = Arg.m_range;
   this->m_travel     = Arg.m_travel;
-  this->m_updateTime = Arg.m_updateTime;
 
   return *this;
 }
 
-void shell::update()
-{	
-  physics::time_t now( physics::runTime::create()->now() );
-  vec2d displacement( this->velocity() * (now - m_updateTime) );
-
-  this->translate( displacement );
- 
-  m_travel += displacement.magnitude();
-  
-  if( m_travel > m_range )
-    {
-      this->destroy();
-    }
-	
-  m_updateTime = now;
-	
-  return;
-}
-
 void shell::destroy()
 {
   this->item::destroy();
@@ -11,7 +11,30 @@
 #include "lock.h"
 #include "util.h"
 #include "flags.h"
+#include "parallel.h"
 #include <pthread.h>
+#include <boost/bind.hpp>
+
+/** add a shell to the world, deferred by weapon::fire() */
+static void spawnShell( const vec2d Position, const vec2d Velocity )
+{
+  active::ptr sh( new shell( Position,Velocity ) );
+  util::note_new_bullet(sh);
+  elementManager::create()->insert(sh);
+
+  return;
+}
+
+/** add a rock to the world, deferred by rock::destroy() and
+    turret::destroy() */
+static void spawnRock( const vec2d Position, const vec2d Velocity, const size_t Size )
+{
+  active::ptr rck( new rock( Position,Velocity,Size ) );
+  elementManager::create()->insert( rck );
+
+  return;
+}
+
 // <-- class weapon -->
 
 weapon::weapon():
@@ -44,21 +67,19 @@ const weapon& weapon::operator=( const weapon& Arg )
   return *this;
 }
 	
-void weapon::fire( const shape* Parent )
+void weapon::fire( const shape* Parent, const physics::time_t Now )
 {
-  const physics::time_t now( physics::runTime::create()->now() );
-
-  if( now > m_time_of_next_fireing )
+  if( Now > m_time_of_next_fireing )
     {
-        // locally-created bullets go into the sync queue.
+        // locally-created bullets go into the sync queue. Fired
+        // during the parallel update, so the shells are made once it
+        // is over.
         for (int i=0; i<bullet_factor; ++i) {
-        active::ptr sh(new shell( Parent->front(),Parent->velocity() 
-                                  + Parent->orientation()*m_muzzel_velocity));
-        util::note_new_bullet(sh);
-        elementManager::create()->insert(sh);
+        parallel::defer( boost::bind( &spawnShell, Parent->front(),Parent->velocity() 
+                                      + Parent->orientation()*m_muzzel_velocity ) );
         }
 	
-      m_time_of_next_fireing = now + m_period_of_fire;
+      m_time_of_next_fireing = Now + m_period_of_fire;
     }
 
   return;
@@ -74,10 +95,10 @@ ship::ship( const vec2d& Position, control* Control, active::kind_t k ):
   m_mass( 100.0 ),
   m_weapon_one( new weapon() ),
   m_invunrableTime(1.0),
-  m_updateTime( physics::runTime::create()->now() ),
   m_mutex(PTHREAD_RECURSIVE_MUTEX_INITIALIZER_NP),
   m_kind(k)
 {
+  this->setTag( entityStore::kShip );
 }
 
 ship::ship( const ship& Arg):
@@ -88,7 +109,6 @@ ship::ship( const ship& Arg):
   m_mass( Arg.m_mass ),
   m_weapon_one( new weapon( *Arg.m_weapon_one) ),
   m_invunrableTime( Arg.m_invunrableTime ),
-  m_updateTime( Arg.m_updateTime ),
   m_mutex(PTHREAD_RECURSIVE_MUTEX_INITIALIZER_NP),
   m_kind(Arg.m_kind)
 {
@@ -102,6 +122,8 @@ void ship::setState(const vec2d& pos, const vec2d& vel,
   velocity() = vel;
   orientation() = orient;
   setAngle(angle);
+  moved();
+  kick();
     //  printf ("setState(orient=(%f, %f))\n", orient.x(), orient.y());
 }
 	
@@ -131,18 +153,22 @@ const ship& ship::operator=( const ship& Arg )
   this->m_mass           = Arg.m_mass;
   this->m_weapon_one     = new weapon( *Arg.m_weapon_one );
   this->m_invunrableTime = Arg.m_invunrableTime; 
-  this->m_updateTime     = Arg.m_updateTime;
   this->m_kind = Arg.m_kind;
 
   pthread_mutex_unlock(&m_mutex);
   return *this;
 }
 
-void ship::update()
+void ship::update( const physics::tick& Tick )
 {
   //  if (!m_control) 
   //    return;
   pthread_mutex_lock(&m_mutex);
+
+  // the ship only turns while a key is held, entityStore::integrate()
+  // applies the turn and the velocity after this
+  this->rotation() = 0.0;
+
   if (m_control) {
     if( m_control->state(FORWARD) )  // forward
       {
@@ -166,21 +192,12 @@ void ship::update()
 
     if( m_control->state(FIRE) )  // fire
       {
-	m_weapon_one->fire(this);
+	m_weapon_one->fire(this,Tick.now);
       }
   }
-  const physics::time_t now( physics::runTime::create()->now() );
-  const physics::time_t duration( now - m_updateTime );
   
-  this->rotate( this->rotation() * duration );
-  this->translate( this->velocity() * duration);
-  
-  if( m_invunrableTime > 0.0 ) m_invunrableTime -= duration;
-
-  m_updateTime = now;
+  if( m_invunrableTime > 0.0 ) m_invunrableTime -= Tick.length;
 
-  this->rotation() = 0.0;
-  
   pthread_mutex_unlock(&m_mutex);
   return;
 }
@@ -221,7 +238,7 @@ void ship::destroy()
     {}
   else
     {
-      game::playerDestroyed();
+      parallel::defer( &game::playerDestroyed );
       this->item::destroy();
     }
 
@@ -234,12 +251,53 @@ void ship::destroy()
 static int s_rock_cnt;
 pthread_mutex_t s_rockcnt_lock = PTHREAD_MUTEX_INITIALIZER;
 
+/** kOutlines outlines for each size of rock from 1 up, made by
+    rock::makeOutlines() */
+static std::vector<physics::clip::ptr> s_outlines;
+static pthread_mutex_t s_outlines_lock = PTHREAD_MUTEX_INITIALIZER;
+
+void rock::makeOutlines()
+{
+  Lock m(s_outlines_lock);
+
+  if( !s_outlines.empty() )
+    return;
+
+  s_outlines.reserve( kLargest * kOutlines );
+
+  randomStream& random( elementManager::create()->random( elementManager::kOutlineStream ) );
+
+  for( size_t size(1); size<=kLargest; ++size )
+    {
+      for( size_t i(0); i<kOutlines; ++i )
+	{
+	  s_outlines.push_back( physics::clip::ptr( new physics::clip( physics::rockClip( size*10.0,size*2 + 3,random ) ) ) );
+	}
+    }
+
+  return;
+}
+
+const physics::clip::ptr rock::outline( const size_t Size )
+{
+  if( (Size < 1) || (Size > kLargest) )
+    {
+      randomStream& random( elementManager::create()->random( elementManager::kOutlineStream ) );
+
+      return physics::clip::ptr( new physics::clip( physics::rockClip( Size*10.0,Size*2 + 3,random ) ) );
+    }
+
+  makeOutlines();
+
+  return s_outlines[ (Size - 1)*kOutlines + elementManager::create()->random( elementManager::kRockStream ).below( kOutlines ) ];
+}
+
 rock::rock( const vec2d& Location,const vec2d& Velocity,const size_t Size ):
-  shape( Location,Velocity,physics::rockClip( Size*10.0,Size*2 + 3 ) ),
-  m_size(Size),
-  m_updateTime(physics::runTime::create()->now())
+  shape( Location,Velocity,outline(Size) ),
+  m_size(Size)
 {
-  this->rotation() = (std::rand())/static_cast<float>(RAND_MAX) - 0.5;
+  this->setTag( entityStore::kRock );
+  this->rotation() = elementManager::create()->random( elementManager::kRockStream ).uniform() - 0.5;
  
   game::state::create()->targetAdded(); 
   {
@@ -250,8 +308,7 @@ rock::rock( const vec2d& Location,const vec2d& Velocity,const size_t Size ):
 
 rock::rock( const rock& Arg ):
   shape(Arg),
-  m_size(Arg.size()),
-  m_updateTime( Arg.m_updateTime )
+  m_size(Arg.size())
 {
   Lock m(s_rockcnt_lock);
   s_rock_cnt++;
@@ -281,43 +338,26 @@ const rock& rock::operator=( const rock& Arg )
 {
   this->shape::operator=(Arg);
   this->m_size = Arg.size();
-  this->m_updateTime = Arg.m_updateTime;
   
   return *this;
 }
 	
-void rock::update()
-{
-  const physics::time_t now( physics::runTime::create()->now() );
-  const physics::time_t duration( now - m_updateTime );
-  
-  this->rotate( this->rotation() * duration );
-  this->translate( this->velocity() * duration);
-  
-  m_updateTime = now;
-
-  return;
-}
-
 void rock::destroy()
 {
   this->item::destroy();
 	
   if( m_size > 3.0 )
     {
-      elementManager* world( elementManager::create() );
-
       vec2d direction(0.0,1.0);
       
-      direction.rotate( ((std::rand())/(double)RAND_MAX) * M_PI );
+      direction.rotate( elementManager::create()->random( elementManager::kDebrisStream ).uniform() * M_PI );
       const float angle( M_PI/2.0 );
 	
       for( size_t i(0);i<4;++i )
 	{
-	  active::ptr rck( new rock( this->position() + direction * 30.0,
-				   direction * 10.0 + this->velocity(),
-				     m_size / 4 ));
-	  world->insert( rck);
+	  parallel::defer( boost::bind( &spawnRock, this->position() + direction * 30.0,
+					direction * 10.0 + this->velocity(),
+					m_size / 4 ) );
 	  
 	  direction.rotate( angle );
 	}
@@ -357,6 +397,8 @@ turret::turret( const vec2d& Location,const vec2d& Velocity,control::ptr Control
   m_weapon(new weapon(2.0)),
   m_rot(0.5)
 {
+  this->setTag( entityStore::kTurret );
+
   m_control->setActiveTarget(this);
   game::state::create()->targetAdded();
 }
@@ -396,8 +438,11 @@ const turret& turret::operator=( const turret& Arg )
   return *this;
 }
 
-void turret::update()
+void turret::update( const physics::tick& Tick )
 {
+  // as ship::update(), the turn is applied by entityStore::integrate()
+  this->rotation() = 0.0;
+
   if( m_control->state(LEFT) )  // left
     {
       this->rotation() = -m_rot;
@@ -410,19 +455,9 @@ void turret::update()
 
   if( m_control->state(FIRE) )  // fire
     {
-      m_weapon->fire(this);
+      m_weapon->fire(this,Tick.now);
     }
 
-  const physics::time_t now( physics::runTime::create()->now() );
-  const physics::time_t duration( now - m_updateTime );
-  
-  this->rotate( this->rotation() * duration );
-  this->translate( this->velocity() * duration);
-  
-  m_updateTime = now;
-
-  this->rotation() = 0.0;
-  
   return;
 }
 
@@ -430,19 +465,16 @@ void turret::destroy()
 {
   this->item::destroy();
 	
-  elementManager* world( elementManager::create() );
-  
   vec2d direction(0.0,1.0);
   
-  direction.rotate( ((std::rand())/(double)RAND_MAX) * M_PI );
+  direction.rotate( elementManager::create()->random( elementManager::kDebrisStream ).uniform() * M_PI );
   const float angle( M_PI/2.0 );
   
   for( size_t i(0);i<4;++i )
     {
-      active::ptr rck(new rock( this->position() + direction * 20.0,
-			       direction * 10.0 + this->velocity(),
-				1 ));
-      world->insert( rck );
+      parallel::defer( boost::bind( &spawnRock, this->position() + direction * 20.0,
+				    direction * 10.0 + this->velocity(),
+				    1 ) );
       
       direction.rotate( angle );
     }
@@ -458,7 +490,7 @@ std::vector<active::ptr>& generateRocks( const size_t Count, std::vector<active:
   // generate rocks and insert into world
   for( size_t i(0);i<Count;++i )
     {
-      velocity.rotate( (rand()/(static_cast<float>(RAND_MAX))) * (2.0 * M_PI) );
+      velocity.rotate( elementManager::create()->random( elementManager::kLayoutStream ).uniform() * (2.0 * M_PI) );
       Container.push_back( active::ptr(new rock( position,velocity,4 )) );
     }
 
@@ -473,7 +505,7 @@ std::vector<active::ptr>& generateTurrets( const size_t Count, std::vector<activ
   // generate rocks and insert into world
   for( size_t i(0);i<Count;++i )
     {
-      velocity.rotate( (rand()/(static_cast<float>(RAND_MAX))) * (2.0 * M_PI) );
+      velocity.rotate( elementManager::create()->random( elementManager::kLayoutStream ).uniform() * (2.0 * M_PI) );
       Container.push_back( active::ptr(new turret( 
          position,velocity,
 	 ai::manager::create()->generate<ai::turret>() )) );